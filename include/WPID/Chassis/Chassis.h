@@ -5,6 +5,10 @@
 #include "../Mechanism/Mechanism.h"
 #include "../Logger.h"
 #include "../Conversion.h"
+#include "../Units.h"
+#include "../Path/PurePursuit.h"
+#include "../Completion.h"
+#include "Drivetrain.h"
 
 namespace wpid {
 /**
@@ -24,6 +28,13 @@ class Chassis {
          */
         float wheel_circumference;
 
+        /**
+         * Track width and wheel circumference in the units passed to the constructor,
+         * converted to inches whenever the measurement units change
+         */
+        float base_track_width;
+        float base_wheel_circumference;
+
         /** 
         * Left and Right mechanisms
         */
@@ -41,6 +52,12 @@ class Chassis {
         */
         float straight_offset = 0;
         float turn_offset = 0;
+
+        /**
+        * Exit tolerances for chained motion in inches and degrees
+        */
+        float straight_chain_tolerance = 2;
+        float turn_chain_tolerance = 5;
         
         /**
         * The units used for distances
@@ -72,8 +89,34 @@ class Chassis {
          * Chassis will always stay at or below the maximum speed.
          * @param distance the distance in inches
          * @param max_speed the maximum speed the robot will travel
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        virtual Completion straightAsync(float distance, int max_speed) = 0;
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, with
+         * exit conditions and progress triggers checked on every tick.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel
+         * @param options the exit conditions and triggers, with distances in the same units as the distance
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        virtual Completion straightAsync(float distance, int max_speed, const MoveOptions& options) = 0;
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, returning
+         * as soon as it is within the chain tolerance without stopping.
+         * The next motion continues from the current speed, and the last motion
+         * of a chain should settle so the robot stops:
+         *
+         *     chassis->straightChained(24, 60);
+         *     chassis->turnChained(90, 35);
+         *     chassis->straight(12, 60);
+         *
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel
          */
-        virtual void straightAsync(float distance, int max_speed) = 0;
+        virtual void straightChained(float distance, int max_speed) = 0;
 
         /**
          * @brief Turn the chassis on the spot with PID.
@@ -88,8 +131,37 @@ class Chassis {
          * Chassis will always stay at or below the maximum speed.
          * @param target_angle the target angle in degrees
          * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        virtual Completion turnAsync(float target_angle, int max_speed) = 0;
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, with exit conditions
+         * and progress triggers checked on every tick.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        virtual Completion turnAsync(float target_angle, int max_speed, const MoveOptions& options) = 0;
+
+        /**
+         * @brief Turn the chassis on the spot with PID, returning as soon as it is
+         * within the chain tolerance without stopping.
+         * The next motion continues from the current speed.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         */
+        virtual void turnChained(float target_angle, int max_speed) = 0;
+
+        /**
+         * @brief Drive along a path without stopping at the waypoints using pure pursuit.
+         * The straight PID slows the chassis down over the remaining length of the path.
+         * @param path the path to follow, starting at the robot's current pose
+         * @param max_speed the maximum speed in percent units
+         * @param lookahead the lookahead distance in inches
          */
-        virtual void turnAsync(float target_angle, int max_speed) = 0;
+        virtual void followPath(const Path& path, int max_speed, float lookahead) = 0;
 
         /**
          * @brief Stops the chassis using the default brake mode.
@@ -0,0 +1,212 @@
+#pragma once
+#include "v5.h"
+#include "v5_vcs.h"
+#include <cmath>
+#include "Kinematics.h"
+#include "../Mechanism/Mechanism.h"
+#include "../Completion.h"
+
+namespace wpid {
+/**
+ * @brief Drives a set of wheel mechanisms from body motions.
+ * The kinematics type is a template parameter, so converting a body motion into
+ * wheel targets is inlined into the caller without any virtual calls, and the same
+ * control code is shared by every drive type:
+ *
+ *     Drivetrain<TankKinematics> drive = Drivetrain<TankKinematics>(TankKinematics(12.5, 10.2), {left, right});
+ *     drive.moveBy({24, 0, 0}, 60, -1);
+ *
+ * @tparam K the kinematics of the drive type, such as TankKinematics or HKinematics
+ */
+template <typename K>
+class Drivetrain {
+    public:
+        typedef typename K::Wheels Wheels;
+
+    private:
+        /**
+        * Kinematics of the wheel layout
+        */
+        K kinematics;
+
+        /**
+        * Wheel mechanisms, in the order the kinematics expects
+        */
+        Mechanism* wheels[K::WHEELS] = {};
+
+        /**
+        * Wheel positions in degrees when odometry was last read
+        */
+        Wheels previous = {};
+
+    public:
+        Drivetrain() = default;
+
+        /**
+         * @brief Construct a new Drivetrain object.
+         * @param kinematics the kinematics of the wheel layout
+         * @param wheels the wheel mechanisms, in the order the kinematics expects
+         */
+        Drivetrain(const K& kinematics, std::initializer_list<Mechanism*> wheels) : kinematics(kinematics) {
+            int i = 0;
+            for(Mechanism* wheel : wheels){
+                if(i < K::WHEELS) {this->wheels[i++] = wheel;}
+            }
+            if(i != K::WHEELS || wheels.size() != (size_t)K::WHEELS)
+                LOG(WARN) << "Drivetrain expected " << (int)K::WHEELS << " wheels but got " << (int)wheels.size();
+        }
+
+        /**
+         * @brief Replaces the kinematics, such as after the measurement units change.
+         * @param kinematics the new kinematics
+         */
+        void setKinematics(const K& kinematics) {this->kinematics = kinematics;}
+
+        /**
+         * @brief Gets the kinematics of the wheel layout.
+         * @return const K& the kinematics
+         */
+        const K& getKinematics() const {return kinematics;}
+
+        /**
+         * @brief Converts a body displacement into wheel targets.
+         * @param motion the displacement in inches and radians
+         * @return Wheels the target of each wheel in degrees
+         */
+        Wheels targets(const BodyMotion& motion) const {
+            return kinematics.inverse(motion);
+        }
+
+        /**
+         * @brief Moves the body by a displacement with each wheel's PID.
+         * Each wheel's max speed is scaled by its share of the largest target so
+         * every wheel arrives at the same time.
+         * @param motion the displacement in inches and radians
+         * @param max_speed the max speed of the wheel with the largest target in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @return Completion the motions of every wheel
+         */
+        Completion moveBy(const BodyMotion& motion, float max_speed, float exit_error) {
+            Wheels exit;
+            for(int i = 0; i < K::WHEELS; i++) {exit[i] = exit_error;}
+            return this->moveBy(motion, max_speed, exit);
+        }
+
+        /**
+         * @brief Moves the body by a displacement with each wheel's PID, with a
+         * separate exit error for each wheel.
+         * @param motion the displacement in inches and radians
+         * @param max_speed the max speed of the wheel with the largest target in percent units
+         * @param exit_error the error in degrees to hand off at for each wheel, or -1 to settle
+         * @return Completion the motions of every wheel
+         */
+        Completion moveBy(const BodyMotion& motion, float max_speed, const Wheels& exit_error) {
+            return this->moveBy(motion, max_speed, exit_error, MoveOptions(), 0);
+        }
+
+        /**
+         * @brief Moves the body by a displacement with each wheel's PID, with exit conditions
+         * and progress triggers. The wheel with the largest target, which every other wheel
+         * keeps pace with, runs the triggers and checks the exit conditions once per tick.
+         * When a condition ends its move it cancels the other wheels, which stop on their next tick.
+         * @param motion the displacement in inches and radians
+         * @param max_speed the max speed of the wheel with the largest target in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in the same units as the amount
+         * @param amount the size of the motion that distances are measured against, such as inches or degrees
+         * @return Completion the motions of every wheel
+         */
+        Completion moveBy(const BodyMotion& motion, float max_speed, float exit_error, const MoveOptions& options, float amount) {
+            Wheels exit;
+            for(int i = 0; i < K::WHEELS; i++) {exit[i] = exit_error;}
+            return this->moveBy(motion, max_speed, exit, options, amount);
+        }
+
+        /**
+         * @brief Moves the body by a displacement with each wheel's PID, with a separate exit
+         * error for each wheel, exit conditions and progress triggers.
+         * A wheel with no distance to cover in a chained motion is stopped rather than
+         * handed off, so it doesn't keep running the previous motion's command.
+         * @param motion the displacement in inches and radians
+         * @param max_speed the max speed of the wheel with the largest target in percent units
+         * @param exit_error the error in degrees to hand off at for each wheel, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in the same units as the amount
+         * @param amount the size of the motion that distances are measured against, such as inches or degrees
+         * @return Completion the motions of every wheel
+         */
+        Completion moveBy(const BodyMotion& motion, float max_speed, const Wheels& exit_error, const MoveOptions& options, float amount) {
+            Wheels target = kinematics.inverse(motion);
+            int lead = 0;
+            for(int i = 0; i < K::WHEELS; i++){
+                if(std::fabs(target[i]) > std::fabs(target[lead])) {lead = i;}
+            }
+            float largest = std::fabs(target[lead]);
+            // distances along the motion become degrees of the lead wheel
+            MoveOptions lead_options = options.scaled(amount > 0 ? largest / amount : 0);
+            Completion completion = Completion::all();
+            // the other wheels start first, so the lead wheel can cancel them when it exits
+            for(int n = 0; n < K::WHEELS; n++){
+                int i = (lead + 1 + n) % K::WHEELS;
+                float speed = largest > 0 ? max_speed * std::fabs(target[i]) / largest : 0;
+                // a chained wheel with nowhere to go is stopped, not left running the last motion's command
+                if(exit_error[i] >= 0 && (target[i] == 0 || speed == 0)){
+                    wheels[i]->stop();
+                    continue;
+                }
+                if(i == lead){
+                    completion.add(wheels[i]->moveRelativeAsync(target[i], speed, lead_options, exit_error[i]));
+                    continue;
+                }
+                MoveHandle wheel = wheels[i]->moveRelativeAsync(target[i], speed, exit_error[i]);
+                if(!options.empty()) {lead_options.cancelOnExit(wheel);}
+                completion.add(wheel);
+            }
+            return completion;
+        }
+
+        /**
+         * @brief Spins the wheels for a body velocity.
+         * Forward and lateral are in percent of the drive wheels' surface speed, and
+         * rotation is in radians per inch on the same scale. If any wheel would pass
+         * the max speed, every wheel is scaled down together to keep the direction.
+         * @param velocity the body velocity
+         * @param max_speed the max speed of any wheel in percent units
+         */
+        void spin(const BodyMotion& velocity, float max_speed) {
+            Wheels speed;
+            kinematics.toWheels(velocity, speed.value);
+            float largest = 0;
+            for(int i = 0; i < K::WHEELS; i++){
+                speed[i] *= kinematics.speedScale(i);
+                largest = std::fmax(largest, std::fabs(speed[i]));
+            }
+            float scale = largest > max_speed ? max_speed / largest : 1;
+            for(int i = 0; i < K::WHEELS; i++){
+                wheels[i]->spin(speed[i] * scale);
+            }
+        }
+
+        /**
+         * @brief Starts odometry from the current wheel positions.
+         */
+        void resetOdometry() {
+            for(int i = 0; i < K::WHEELS; i++){
+                previous[i] = wheels[i]->getPosition(vex::deg);
+            }
+        }
+
+        /**
+         * @brief Gets how far the body has moved since odometry was last read.
+         * @return BodyMotion the displacement in inches and radians
+         */
+        BodyMotion odometry() {
+            Wheels delta;
+            for(int i = 0; i < K::WHEELS; i++){
+                float position = wheels[i]->getPosition(vex::deg);
+                delta[i] = position - previous[i];
+                previous[i] = position;
+            }
+            return kinematics.forward(delta);
+        }
+};
+}
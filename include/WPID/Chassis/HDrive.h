@@ -24,19 +24,62 @@ class HDrive : public wpid::Tank {
         * Offset to fix consistent error
         */
         float strafe_offset = 0;
+
+        /**
+        * Exit tolerance for chained strafing in inches
+        */
+        float strafe_chain_tolerance = 2;
+
+        /**
+        * Center wheel circumference in the units passed to the constructor
+        */
+        float base_center_wheel_circumference;
         
         /**
-         * @brief Sets the target position of each side of the chassis.
-         * Uses the PID algorithm to determine speeds of the motors.
-         * This function is inaccessable and is used as a helper.
-         * @param left_target the left side's target
-         * @param right_target the right side's target
-         * @param center_target the center wheels' target
-         * @param l_max_spd the max speed the left side should spin
-         * @param r_max_spd the max speed the right side should spin
-         * @param c_max_spd the max speed the center wheel should spin
-         */
-        void spinToTarget(float left_target, float right_target, float center_target, int l_max_spd, int r_max_spd, int c_max_spd);
+        * Left, right and center wheels driven through the H drive kinematics
+        */
+        Drivetrain<HKinematics> drive;
+
+        /**
+         * @brief Starts a straight motion that settles, or hands off at the exit error.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in inches or degrees of turning
+         * @return Completion the motions of each side
+         */
+        Completion straightMotion(float distance, int max_speed, float exit_error, const MoveOptions& options = MoveOptions());
+
+        /**
+         * @brief Starts a turn that settles, or hands off at the exit error.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in inches or degrees of turning
+         * @return Completion the motions of each side
+         */
+        Completion turnMotion(float target_angle, int max_speed, float exit_error, const MoveOptions& options = MoveOptions());
+
+        /**
+         * @brief Starts a strafe that settles, or hands off at the exit error.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in inches or degrees of turning
+         * @return Completion the motions of each wheel
+         */
+        Completion strafeMotion(float distance, int max_speed, float exit_error, const MoveOptions& options = MoveOptions());
+
+        /**
+         * @brief Starts a diagonal motion that settles, or hands off at the exit errors.
+         * @param straight_distance the distance going forward or backwards in inches
+         * @param strafe_distance the distance going sideways in inches
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
+         * @param exit_error the side wheel error in degrees to hand off at, or -1 to settle
+         * @param center_exit_error the center wheel error in degrees to hand off at, or -1 to settle
+         * @return Completion the motions of each wheel
+         */
+        Completion diagonalMotion(float straight_distance, float strafe_distance, int straight_max_speed, float exit_error, float center_exit_error);
     
     public:
         /**
@@ -100,8 +143,28 @@ class HDrive : public wpid::Tank {
          * Chassis will always stay at or below the maximum speed.
          * @param distance the distance in inches
          * @param max_speed the maximum speed the robot will travel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(float distance, int max_speed) override;
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, with
+         * exit conditions and progress triggers checked on every tick.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param options the exit conditions and triggers, with distances in the same units as the distance
+         * @return Completion a handle to wait on or cancel the motion
          */
-        void straightAsync(float distance, int max_speed) override;
+        Completion straightAsync(float distance, int max_speed, const MoveOptions& options) override;
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, returning
+         * as soon as it is within the chain tolerance without stopping.
+         * The next motion continues from the current speed.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straightChained(float distance, int max_speed) override;
 
         /**
          * @brief Turn the chassis on the spot with PID.
@@ -116,8 +179,28 @@ class HDrive : public wpid::Tank {
          * Chassis will always stay at or below the maximum speed.
          * @param target_angle the target angle in degrees
          * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
          */
-        void turnAsync(float target_angle, int max_speed) override;
+        Completion turnAsync(float target_angle, int max_speed) override;
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, with exit conditions
+         * and progress triggers checked on every tick.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(float target_angle, int max_speed, const MoveOptions& options) override;
+
+        /**
+         * @brief Turn the chassis on the spot with PID, returning as soon as it is
+         * within the chain tolerance without stopping.
+         * The next motion continues from the current speed.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         */
+        void turnChained(float target_angle, int max_speed) override;
 
         /**
          * @brief Strafe the chassis sideways with PID.
@@ -132,30 +215,193 @@ class HDrive : public wpid::Tank {
          * Chassis will always stay at or below the maximum speed.
          * @param distance the distance to travel in inches
          * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion strafeAsync(float distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously with PID, with exit conditions
+         * and progress triggers checked on every tick.
+         * @param distance the distance in inches, positive to the right
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in the same units as the distance
+         * @return Completion a handle to wait on or cancel the motion
          */
-        void strafeAsync(float distance, int max_speed);
+        Completion strafeAsync(float distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Strafe the chassis sideways with PID, returning as soon as it is
+         * within the chain tolerance without stopping.
+         * The next motion continues from the current speed.
+         * @param distance the distance to travel in inches
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafeChained(float distance, int max_speed);
 
          /**
          * @brief Move the chassis on a diagonal a specific distance with PID.
          * Chassis will always stay at or below the maximum speed.
-         * The speed of the center wheel is calculated in the function as being proportional to the distance traveled.
-         * If the straight distance is 100, and center is 30, the center wheel will spin at 30% the speed of straight_max_speed.
+         * The wheel with the furthest to go spins at the max speed, and the others are scaled
+         * down by their share of the distance so both directions finish at the same time.
          * @param straight_distance the distance going forward or backwards in inches
          * @param strafe_distance the distance going sideways in inches
-         * @param straight_max_speed the maximum speed the robot will travel in percent units
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
          */
         void diagonal(float straight_distance, float strafe_distance, int straight_max_speed);
 
          /**
          * @brief Move the chassis on a diagonal asynchronously a specific distance with PID.
          * Chassis will always stay at or below the maximum speed.
-         * The speed of the center wheel is calculated in the function as being proportional to the distance traveled.
-         * If the straight distance is 100, and center is 30, the center wheel will spin at 30% the speed of straight_max_speed.
+         * The wheel with the furthest to go spins at the max speed, and the others are scaled
+         * down by their share of the distance so both directions finish at the same time.
+         * @param straight_distance the distance going forward or backwards in inches
+         * @param strafe_distance the distance going sideways in inches
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion diagonalAsync(float straight_distance, float strafe_distance, int straight_max_speed);
+
+        /**
+         * @brief Move the chassis on a diagonal with PID, returning as soon as both
+         * axes are within their chain tolerance without stopping.
+         * The next motion continues from the current speed.
          * @param straight_distance the distance going forward or backwards in inches
          * @param strafe_distance the distance going sideways in inches
-         * @param straight_max_speed the maximum speed the robot will travel in percent units
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void diagonalChained(float straight_distance, float strafe_distance, int straight_max_speed);
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, using a typed length such as 24_in.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straight(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, using a typed
+         * length, with exit conditions and progress triggers checked on every tick.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(Length distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Move the chassis forward without stopping at the end, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straightChained(Length distance, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot with PID, using a typed angle such as 90_deg.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         */
+        void turn(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, using a typed angle.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, using a typed angle,
+         * with exit conditions and progress triggers checked on every tick.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(Angle target_angle, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Turn the chassis on the spot without stopping at the end, using a typed angle.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         */
+        void turnChained(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways with PID, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafe(Length distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously with PID, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
          */
-        void diagonalAsync(float straight_distance, float strafe_distance, int straight_max_speed);
+        Completion strafeAsync(Length distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously with PID, using a typed length, with exit
+         * conditions and progress triggers checked on every tick.
+         * @param distance the distance to strafe
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion strafeAsync(Length distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Strafe the chassis sideways without stopping at the end, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafeChained(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis on a diagonal with PID, using typed lengths.
+         * @param straight_distance the distance going forward or backwards
+         * @param strafe_distance the distance going sideways
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void diagonal(Length straight_distance, Length strafe_distance, int straight_max_speed);
+
+        /**
+         * @brief Move the chassis on a diagonal asynchronously with PID, using typed lengths.
+         * @param straight_distance the distance going forward or backwards
+         * @param strafe_distance the distance going sideways
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion diagonalAsync(Length straight_distance, Length strafe_distance, int straight_max_speed);
+
+        /**
+         * @brief Move the chassis on a diagonal without stopping at the end, using typed lengths.
+         * @param straight_distance the distance going forward or backwards
+         * @param strafe_distance the distance going sideways
+         * @param straight_max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void diagonalChained(Length straight_distance, Length strafe_distance, int straight_max_speed);
+
+        /**
+         * @brief Drive along a path without stopping at the waypoints using pure pursuit.
+         * The chassis translates towards the lookahead point each tick using the center wheel
+         * while the turn PID holds its starting heading. The straight PID slows it down
+         * over the remaining length of the path.
+         * @param path the path to follow, starting at the robot's current pose
+         * @param max_speed the maximum speed in percent units
+         * @param lookahead the lookahead distance in inches
+         */
+        void followPath(const Path& path, int max_speed, float lookahead) override;
 
         /**
          * @brief Stops the chassis using the default brake mode.
@@ -211,6 +457,31 @@ class HDrive : public wpid::Tank {
          */
         void setMaxAcceleration(float straight_max_accel, float c_max_accel);
 
+        /**
+         * @brief Turns on battery voltage compensation for every wheel,
+         * so motions take the same time on a fresh or drained battery.
+         * @param nominal the battery voltage 100 percent maps to in volts, or 0 to turn compensation off
+         */
+        void setVoltageCompensation(float nominal);
+
+        /**
+         * @brief Turns on thermal limiting for every wheel, so the drive slows down
+         * gradually as it heats up instead of the motor firmware cutting its power.
+         * @param start the temperature to start throttling at in celsius
+         * @param limit the temperature where the minimum scale is reached in celsius
+         * @param min_scale the lowest fraction of the output and current to allow
+         * @param max_current the current limit of each wheel's motors when they are cool in amps
+         */
+        void setThermalLimit(float start, float limit, float min_scale = 0.5, float max_current = 2.5);
+
+        /**
+         * @brief Runs every wheel's moves as a position loop cascaded into a faster
+         * velocity loop, which holds the wheel speeds more tightly under load.
+         * @param velocity_pid the velocity loop's gains, with a shorter delay time than the drive PIDs
+         * @param max_velocity the wheel rpm at 100 percent
+         */
+        void setCascade(PID velocity_pid, float max_velocity);
+
         /**
          * @brief Set the offset for the straight and turn functions.
          * This value is in inches, and will add to the input of each movement funciton.
@@ -220,6 +491,15 @@ class HDrive : public wpid::Tank {
          */
         void setOffset(float straight, float turn, float strafe);
 
+        /**
+         * @brief Set how close a chained motion must get to its target before the next motion starts.
+         * Larger values blend motions together sooner, smaller values follow each motion more closely.
+         * @param straight the straight tolerance in inches
+         * @param turn the turn tolerance in degrees
+         * @param strafe the strafe tolerance in inches
+         */
+        void setChainTolerance(float straight, float turn, float strafe);
+
         /**
          * @brief Set the timeout to use for PID movement. If the timeout is exceeded, 
          * the system will stop regardless of the current error or speed.
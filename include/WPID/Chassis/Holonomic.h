@@ -0,0 +1,493 @@
+#pragma once
+#include "Chassis.h"
+
+namespace wpid {
+/**
+ * @brief A four wheel holonomic chassis, such as an X-drive or a mecanum drive.
+ * The wheel layout is described by HolonomicKinematics, so any combination of
+ * forward, sideways and turning motion is driven with every wheel arriving together:
+ *
+ *     chassis = new Holonomic(Holonomic::xDrive(12.5, 1.625), &frontLeft, &frontRight, &backLeft, &backRight, 1);
+ *     chassis->move(24, 12, 90, 60);
+ */
+class Holonomic : public wpid::Chassis {
+    private:
+        /**
+        * Back wheel mechanisms, the front wheels are the Chassis left and right
+        */
+        Mechanism* back_left;
+        Mechanism* back_right;
+
+        /**
+        * The four wheels driven through the holonomic kinematics
+        */
+        Drivetrain<HolonomicKinematics> drive;
+
+        /**
+        * Kinematics in the units passed to the constructor
+        */
+        HolonomicKinematics base_kinematics;
+
+        /**
+        * PID object for strafing
+        */
+        PID pidStrafe;
+
+        /**
+        * Offset to fix consistent error
+        */
+        float strafe_offset = 0;
+
+        /**
+        * Exit tolerance for chained strafing in inches
+        */
+        float strafe_chain_tolerance = 2;
+
+        /**
+         * @brief Starts a motion of the body that settles, or hands off at the chain tolerance.
+         * The wheels use the turn PID for pure turns, the strafe PID for pure strafes
+         * and the straight PID for everything else.
+         * @param motion the displacement in inches and radians
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         * @param chained true to hand off at the chain tolerance instead of settling
+         * @param options the exit conditions and triggers, with distances in inches, or degrees for pure turns
+         * @return Completion the motions of each wheel
+         */
+        Completion motion(BodyMotion motion, int max_speed, bool chained, const MoveOptions& options = MoveOptions());
+
+        /**
+         * @brief Starts a straight motion with the straight offset added.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param chained true to hand off at the chain tolerance instead of settling
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion the motions of each wheel
+         */
+        Completion straightInches(float distance, int max_speed, bool chained, const MoveOptions& options = MoveOptions());
+
+        /**
+         * @brief Starts a strafe motion with the strafe offset added.
+         * @param distance the distance in inches, positive to the right
+         * @param max_speed the maximum speed in percent units
+         * @param chained true to hand off at the chain tolerance instead of settling
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion the motions of each wheel
+         */
+        Completion strafeInches(float distance, int max_speed, bool chained, const MoveOptions& options = MoveOptions());
+
+    public:
+        /**
+         * @brief Construct a new Holonomic object.
+         * @param kinematics the wheel layout, from xDrive(), mecanum() or a custom matrix
+         * @param front_left motor group
+         * @param front_right motor group
+         * @param back_left motor group
+         * @param back_right motor group
+         * @param drive_gear_ratio the internal gearset of the drive train
+         */
+        Holonomic(HolonomicKinematics kinematics, vex::motor_group* front_left, vex::motor_group* front_right,
+                  vex::motor_group* back_left, vex::motor_group* back_right, float drive_gear_ratio);
+        Holonomic() = default;
+
+        /**
+         * @brief Builds the kinematics of an X-drive with the wheels on the corners of a square at 45 degrees.
+         * @param track_width the width between the left and right wheels
+         * @param wheel_radius radius of the wheels
+         * @return HolonomicKinematics the wheel layout
+         */
+        static HolonomicKinematics xDrive(float track_width, float wheel_radius);
+
+        /**
+         * @brief Builds the kinematics of a mecanum drive with 45 degree rollers.
+         * @param track_width the width between the left and right wheels
+         * @param wheel_base the distance between the front and back wheels
+         * @param wheel_radius radius of the wheels
+         * @return HolonomicKinematics the wheel layout
+         */
+        static HolonomicKinematics mecanum(float track_width, float wheel_base, float wheel_radius);
+
+        /**
+         * @brief Sets the straight PID object.
+         * @param pid a PID object holding the constants for driving straight
+         */
+        void setStraightPID(PID pid) override;
+
+        /**
+         * @brief Sets the turning PID object.
+         * @param pid a PID object holding the constants for turning on the spot
+         */
+        void setTurnPID(PID pid) override;
+
+        /**
+         * @brief Sets the strafing PID object.
+         * @param pid a PID object holding the constants for strafing sideways
+         */
+        void setStrafePID(PID pid);
+
+        /**
+         * @brief Spin the chassis with a velocity in each direction, such as from a controller.
+         * If a wheel would pass full speed every wheel is slowed down together.
+         * @param forward the forward velocity in percent units
+         * @param lateral the velocity to the right in percent units
+         * @param turn the clockwise turning velocity in percent units
+         */
+        void spin(int forward, int lateral, int turn);
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straight(float distance, int max_speed) override;
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(float distance, int max_speed) override;
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, with
+         * exit conditions and progress triggers checked on every tick.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param options the exit conditions and triggers, with distances in the same units as the distance
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(float distance, int max_speed, const MoveOptions& options) override;
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, returning
+         * as soon as it is within the chain tolerance without stopping.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straightChained(float distance, int max_speed) override;
+
+        /**
+         * @brief Turn the chassis on the spot with PID.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         */
+        void turn(int target_angle, int max_speed) override;
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(float target_angle, int max_speed) override;
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, with exit conditions
+         * and progress triggers checked on every tick.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(float target_angle, int max_speed, const MoveOptions& options) override;
+
+        /**
+         * @brief Turn the chassis on the spot with PID, returning as soon as it is
+         * within the chain tolerance without stopping.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         */
+        void turnChained(float target_angle, int max_speed) override;
+
+        /**
+         * @brief Strafe the chassis sideways a specific distance with PID.
+         * @param distance the distance in inches, positive to the right
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafe(float distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously a specific distance with PID.
+         * @param distance the distance in inches, positive to the right
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion strafeAsync(float distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously with PID, with exit conditions
+         * and progress triggers checked on every tick.
+         * @param distance the distance in inches, positive to the right
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in the same units as the distance
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion strafeAsync(float distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Strafe the chassis sideways with PID, returning as soon as it is
+         * within the chain tolerance without stopping.
+         * @param distance the distance in inches, positive to the right
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafeChained(float distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward, sideways and turn at the same time with PID.
+         * The wheel speeds are scaled together so every direction finishes at the same time.
+         * @param forward the forward distance in inches
+         * @param lateral the distance to the right in inches
+         * @param angle the clockwise angle to turn in degrees
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void move(float forward, float lateral, float angle, int max_speed);
+
+        /**
+         * @brief Move the chassis forward, sideways and turn at the same time asynchronously with PID.
+         * @param forward the forward distance in inches
+         * @param lateral the distance to the right in inches
+         * @param angle the clockwise angle to turn in degrees
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion moveAsync(float forward, float lateral, float angle, int max_speed);
+
+        /**
+         * @brief Move the chassis forward, sideways and turn at the same time with PID,
+         * returning as soon as it is within the chain tolerance without stopping.
+         * @param forward the forward distance in inches
+         * @param lateral the distance to the right in inches
+         * @param angle the clockwise angle to turn in degrees
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void moveChained(float forward, float lateral, float angle, int max_speed);
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, using a typed length such as 24_in.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straight(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, using a typed
+         * length, with exit conditions and progress triggers checked on every tick.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(Length distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Move the chassis forward without stopping at the end, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straightChained(Length distance, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot with PID, using a typed angle such as 90_deg.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         */
+        void turn(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, using a typed angle.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, using a typed angle,
+         * with exit conditions and progress triggers checked on every tick.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(Angle target_angle, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Turn the chassis on the spot without stopping at the end, using a typed angle.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         */
+        void turnChained(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways a specific distance with PID, using a typed length.
+         * @param distance the distance to travel, positive to the right
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafe(Length distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously with PID, using a typed length.
+         * @param distance the distance to travel, positive to the right
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion strafeAsync(Length distance, int max_speed);
+
+        /**
+         * @brief Strafe the chassis sideways asynchronously with PID, using a typed length,
+         * with exit conditions and progress triggers checked on every tick.
+         * @param distance the distance to travel, positive to the right
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion strafeAsync(Length distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Strafe the chassis sideways without stopping at the end, using a typed length.
+         * @param distance the distance to travel, positive to the right
+         * @param max_speed the maximum speed in percent units
+         */
+        void strafeChained(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis with PID, using typed lengths and angles.
+         * @param forward the forward distance
+         * @param lateral the distance to the right
+         * @param angle the clockwise angle to turn
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void move(Length forward, Length lateral, Angle angle, int max_speed);
+
+        /**
+         * @brief Move the chassis asynchronously with PID, using typed lengths and angles.
+         * @param forward the forward distance
+         * @param lateral the distance to the right
+         * @param angle the clockwise angle to turn
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion moveAsync(Length forward, Length lateral, Angle angle, int max_speed);
+
+        /**
+         * @brief Move the chassis without stopping at the end, using typed lengths and angles.
+         * @param forward the forward distance
+         * @param lateral the distance to the right
+         * @param angle the clockwise angle to turn
+         * @param max_speed the maximum speed of the fastest wheel in percent units
+         */
+        void moveChained(Length forward, Length lateral, Angle angle, int max_speed);
+
+        /**
+         * @brief Drive along a path without stopping at the waypoints using pure pursuit.
+         * The chassis translates towards the lookahead point while holding its starting heading.
+         * @param path the path to follow, starting at the robot's current pose
+         * @param max_speed the maximum speed in percent units
+         * @param lookahead the lookahead distance in inches
+         */
+        void followPath(const Path& path, int max_speed, float lookahead) override;
+
+        /**
+         * @brief Stops the chassis using the default brake mode.
+         */
+        void stop() override;
+
+        /**
+         * @brief Waits for the robot to finish a motion.
+         */
+        void waitUntilSettled() override;
+
+        /**
+         * @brief Gets the average position of the left wheels.
+         * @param units typically using rotationUnits::deg
+         * @return float
+         */
+        float getLeftPosition(vex::rotationUnits units) override;
+
+        /**
+         * @brief Gets the average position of the right wheels.
+         * @param units typically using rotationUnits::deg
+         * @return float
+         */
+        float getRightPosition(vex::rotationUnits units) override;
+
+        /**
+         * @brief Reset every wheel encoder to 0.
+         */
+        void resetPosition() override;
+
+        /**
+         * @brief Sets the brake type of the chassis by passing a brake type as a parameter.
+         * @param type The brake type can be set to coast, brake, or hold.
+         */
+        void setBrakeType(vex::brakeType type) override;
+
+        /**
+         * @brief Set the max acceleration of every wheel.
+         * @param max_accel a value to increment to ramp the speed up in velocityUnits::pct
+         */
+        void setMaxAcceleration(float max_accel);
+
+        /**
+         * @brief Turns on battery voltage compensation for every wheel,
+         * so motions take the same time on a fresh or drained battery.
+         * @param nominal the battery voltage 100 percent maps to in volts, or 0 to turn compensation off
+         */
+        void setVoltageCompensation(float nominal);
+
+        /**
+         * @brief Turns on thermal limiting for every wheel, so the drive slows down
+         * gradually as it heats up instead of the motor firmware cutting its power.
+         * @param start the temperature to start throttling at in celsius
+         * @param limit the temperature where the minimum scale is reached in celsius
+         * @param min_scale the lowest fraction of the output and current to allow
+         * @param max_current the current limit of each wheel's motors when they are cool in amps
+         */
+        void setThermalLimit(float start, float limit, float min_scale = 0.5, float max_current = 2.5);
+
+        /**
+         * @brief Runs every wheel's moves as a position loop cascaded into a faster
+         * velocity loop, which holds the wheel speeds more tightly under load.
+         * @param velocity_pid the velocity loop's gains, with a shorter delay time than the drive PIDs
+         * @param max_velocity the wheel rpm at 100 percent
+         */
+        void setCascade(PID velocity_pid, float max_velocity);
+
+        /**
+         * @brief Set the offset for the straight, turn and strafe functions.
+         * @param straight the distance to offset straight motion in inches
+         * @param turn the angle to offset turns in degrees
+         * @param strafe the distance to offset strafing in inches
+         */
+        void setOffset(float straight, float turn, float strafe);
+
+        /**
+         * @brief Set how close a chained motion must get to its target before the next motion starts.
+         * @param straight the straight tolerance in inches
+         * @param turn the turn tolerance in degrees
+         * @param strafe the strafe tolerance in inches
+         */
+        void setChainTolerance(float straight, float turn, float strafe);
+
+        /**
+         * @brief Set the timeout to use for PID movement.
+         * A value of -1 will disable timeouts.
+         * @param timeout in milliseconds
+         */
+        void setTimeout(int timeout);
+
+        /**
+         * @brief Set the measurement units for chassis values.
+         * @param preferred_units the user's measurement system
+         */
+        void setMeasurementUnits(Conversion::measurement preferred_units) override;
+};
+}
@@ -0,0 +1,275 @@
+#pragma once
+#include <cmath>
+#include "../Logger.h"
+
+namespace wpid {
+/**
+ * @brief A motion of the robot body, either a displacement or a velocity.
+ * Forward and lateral are in inches with x to the right, and rotation is in
+ * radians with clockwise positive, the same as the pure pursuit pose.
+ */
+struct BodyMotion {
+    float forward;
+    float lateral;
+    float rotation;
+};
+
+/**
+ * @brief The shared part of every drivetrain's kinematics, using CRTP so the
+ * drive specific math is resolved and inlined at compile time.
+ * A derived class provides toWheels() and toBody() for its wheel layout, working
+ * in inches of wheel surface travel.
+ * @tparam Derived the kinematics class of the drive type
+ * @tparam N the number of independently driven wheels
+ */
+template <typename Derived, int N>
+class Kinematics {
+    public:
+        /**
+        * The number of independently driven wheels
+        */
+        static const int WHEELS = N;
+
+        /**
+        * A value for each wheel, in the order the drivetrain was given its mechanisms
+        */
+        struct Wheels {
+            float value[N];
+            float& operator[](int i) {return value[i];}
+            const float& operator[](int i) const {return value[i];}
+        };
+
+        /**
+         * @brief Converts a body motion into wheel rotations.
+         * @param motion the body motion in inches and radians
+         * @return Wheels the rotation of each wheel in degrees
+         */
+        Wheels inverse(const BodyMotion& motion) const {
+            Wheels wheels;
+            derived().toWheels(motion, wheels.value);
+            for(int i = 0; i < N; i++){
+                wheels[i] = wheels[i] / derived().circumference(i) * 360.0f;
+            }
+            return wheels;
+        }
+
+        /**
+         * @brief Converts wheel rotations into a body motion, used for odometry.
+         * @param wheels the rotation of each wheel in degrees
+         * @return BodyMotion the body motion in inches and radians
+         */
+        BodyMotion forward(const Wheels& wheels) const {
+            float surface[N];
+            for(int i = 0; i < N; i++){
+                surface[i] = wheels[i] / 360.0f * derived().circumference(i);
+            }
+            BodyMotion motion = {0, 0, 0};
+            derived().toBody(surface, motion);
+            return motion;
+        }
+
+        /**
+         * @brief Gets the degrees a wheel turns for one degree of the drive wheels
+         * at the same surface speed, used to share one percent speed scale.
+         * @param i the wheel index
+         * @return float the speed scale of the wheel
+         */
+        float speedScale(int i) const {
+            return derived().circumference(0) / derived().circumference(i);
+        }
+
+    private:
+        const Derived& derived() const {return *static_cast<const Derived*>(this);}
+};
+
+/**
+ * @brief Kinematics of a tank drive with a left and right side.
+ */
+class TankKinematics : public Kinematics<TankKinematics, 2> {
+    private:
+        float track_width = 1;
+        float wheel_circumference = 1;
+
+    public:
+        TankKinematics() = default;
+
+        /**
+         * @brief Construct a new TankKinematics object.
+         * @param track_width the width between left and right in inches
+         * @param wheel_circumference the drive wheel circumference in inches
+         */
+        TankKinematics(float track_width, float wheel_circumference)
+            : track_width(track_width), wheel_circumference(wheel_circumference){};
+
+        float circumference(int) const {return wheel_circumference;}
+
+        void toWheels(const BodyMotion& motion, float* wheels) const {
+            float arc = motion.rotation * track_width / 2;
+            wheels[0] = motion.forward + arc;
+            wheels[1] = motion.forward - arc;
+        }
+
+        void toBody(const float* wheels, BodyMotion& motion) const {
+            motion.forward = (wheels[0] + wheels[1]) / 2;
+            motion.rotation = (wheels[0] - wheels[1]) / track_width;
+        }
+};
+
+/**
+ * @brief Kinematics of an H drive, a tank drive with a sideways center wheel.
+ */
+class HKinematics : public Kinematics<HKinematics, 3> {
+    private:
+        float track_width = 1;
+        float wheel_circumference = 1;
+        float center_wheel_circumference = 1;
+
+    public:
+        HKinematics() = default;
+
+        /**
+         * @brief Construct a new HKinematics object.
+         * @param track_width the width between left and right in inches
+         * @param wheel_circumference the drive wheel circumference in inches
+         * @param center_wheel_circumference the center wheel circumference in inches
+         */
+        HKinematics(float track_width, float wheel_circumference, float center_wheel_circumference)
+            : track_width(track_width), wheel_circumference(wheel_circumference),
+              center_wheel_circumference(center_wheel_circumference){};
+
+        float circumference(int i) const {return i == 2 ? center_wheel_circumference : wheel_circumference;}
+
+        void toWheels(const BodyMotion& motion, float* wheels) const {
+            float arc = motion.rotation * track_width / 2;
+            wheels[0] = motion.forward + arc;
+            wheels[1] = motion.forward - arc;
+            wheels[2] = motion.lateral;
+        }
+
+        void toBody(const float* wheels, BodyMotion& motion) const {
+            motion.forward = (wheels[0] + wheels[1]) / 2;
+            motion.lateral = wheels[2];
+            motion.rotation = (wheels[0] - wheels[1]) / track_width;
+        }
+};
+
+/**
+ * @brief Kinematics of any layout of N wheels, described by a wheel-to-body matrix.
+ * Row i holds the inches wheel i travels for one inch forward, one inch to the right,
+ * and one radian clockwise. Odometry uses the least squares pseudo-inverse of the
+ * matrix, which is computed once when the kinematics are built.
+ * @tparam N the number of wheels
+ */
+template <int N>
+class MatrixKinematics : public Kinematics<MatrixKinematics<N>, N> {
+    private:
+        /**
+        * Wheel surface travel per unit of forward, lateral and rotation
+        */
+        float matrix[N][3] = {};
+
+        /**
+        * Least squares inverse, body motion per inch of wheel surface travel
+        */
+        float pseudo_inverse[3][N] = {};
+
+        float wheel_circumference = 1;
+
+        /**
+         * @brief Computes the pseudo-inverse (AᵀA)⁻¹Aᵀ of the matrix.
+         */
+        void computePseudoInverse() {
+            float ata[3][3] = {};
+            for(int r = 0; r < 3; r++){
+                for(int c = 0; c < 3; c++){
+                    for(int i = 0; i < N; i++) {ata[r][c] += matrix[i][r] * matrix[i][c];}
+                }
+            }
+            // 3x3 inverse from the cofactors
+            float inv[3][3];
+            inv[0][0] = ata[1][1]*ata[2][2] - ata[1][2]*ata[2][1];
+            inv[0][1] = ata[0][2]*ata[2][1] - ata[0][1]*ata[2][2];
+            inv[0][2] = ata[0][1]*ata[1][2] - ata[0][2]*ata[1][1];
+            inv[1][0] = ata[1][2]*ata[2][0] - ata[1][0]*ata[2][2];
+            inv[1][1] = ata[0][0]*ata[2][2] - ata[0][2]*ata[2][0];
+            inv[1][2] = ata[0][2]*ata[1][0] - ata[0][0]*ata[1][2];
+            inv[2][0] = ata[1][0]*ata[2][1] - ata[1][1]*ata[2][0];
+            inv[2][1] = ata[0][1]*ata[2][0] - ata[0][0]*ata[2][1];
+            inv[2][2] = ata[0][0]*ata[1][1] - ata[0][1]*ata[1][0];
+            float det = ata[0][0]*inv[0][0] + ata[0][1]*inv[1][0] + ata[0][2]*inv[2][0];
+            if(std::fabs(det) < 1e-6f){
+                LOG(WARN) << "Kinematic matrix cannot measure every direction of motion";
+                return;
+            }
+            for(int r = 0; r < 3; r++){
+                for(int i = 0; i < N; i++){
+                    float sum = 0;
+                    for(int c = 0; c < 3; c++) {sum += inv[r][c] * matrix[i][c];}
+                    pseudo_inverse[r][i] = sum / det;
+                }
+            }
+        }
+
+    public:
+        MatrixKinematics() = default;
+
+        /**
+         * @brief Construct a new MatrixKinematics object.
+         * @param matrix wheel surface travel in inches per inch forward, inch right and radian clockwise
+         * @param wheel_circumference the wheel circumference in inches
+         */
+        MatrixKinematics(const float (&matrix)[N][3], float wheel_circumference) : wheel_circumference(wheel_circumference) {
+            for(int i = 0; i < N; i++){
+                for(int c = 0; c < 3; c++) {this->matrix[i][c] = matrix[i][c];}
+            }
+            this->computePseudoInverse();
+        }
+
+        /**
+         * @brief Gets a copy with every length multiplied, used to change measurement units.
+         * @param factor the number to multiply lengths by
+         * @return MatrixKinematics the scaled kinematics
+         */
+        MatrixKinematics scaled(float factor) const {
+            MatrixKinematics result = *this;
+            for(int i = 0; i < N; i++) {result.matrix[i][2] *= factor;}
+            result.wheel_circumference *= factor;
+            result.computePseudoInverse();
+            return result;
+        }
+
+        /**
+         * @brief Gets the largest distance a wheel travels per radian the body turns.
+         * @return float the turning radius in inches
+         */
+        float turnRadius() const {
+            float largest = 0;
+            for(int i = 0; i < N; i++) {largest = std::fmax(largest, std::fabs(matrix[i][2]));}
+            return largest;
+        }
+
+        float circumference(int) const {return wheel_circumference;}
+
+        void toWheels(const BodyMotion& motion, float* wheels) const {
+            for(int i = 0; i < N; i++){
+                wheels[i] = matrix[i][0]*motion.forward + matrix[i][1]*motion.lateral + matrix[i][2]*motion.rotation;
+            }
+        }
+
+        void toBody(const float* wheels, BodyMotion& motion) const {
+            float body[3] = {};
+            for(int r = 0; r < 3; r++){
+                for(int i = 0; i < N; i++) {body[r] += pseudo_inverse[r][i] * wheels[i];}
+            }
+            motion.forward = body[0];
+            motion.lateral = body[1];
+            motion.rotation = body[2];
+        }
+};
+
+/**
+ * Kinematics of a four wheel holonomic drive, in the order front left, front right,
+ * back left, back right
+ */
+typedef MatrixKinematics<4> HolonomicKinematics;
+}
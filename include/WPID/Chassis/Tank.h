@@ -6,15 +6,29 @@ namespace wpid{
 class Tank : public wpid::Chassis{
     private:
         /**
-         * @brief Sets the target position of each side of the chassis.
-         * Uses the PID algorithm to determine speeds of the motors.
-         * This function is inaccessable and is used as a helper.
-         * @param left_target the left side's target
-         * @param right_target the right side's target
-         * @param l_max_spd the max speed the left side should spin
-         * @param r_max_spd the max speed the right side should spin
-         */
-        void spinToTarget(float left_target, float right_target, int l_max_spd, int r_max_spd);
+        * Left and right sides driven through the tank kinematics
+        */
+        Drivetrain<TankKinematics> drive;
+
+        /**
+         * @brief Starts a straight motion that settles, or hands off at the exit error.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in inches or degrees of turning
+         * @return Completion the motions of each side
+         */
+        Completion straightMotion(float distance, int max_speed, float exit_error, const MoveOptions& options = MoveOptions());
+
+        /**
+         * @brief Starts a turn that settles, or hands off at the exit error.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @param exit_error the wheel error in degrees to hand off at, or -1 to settle
+         * @param options the exit conditions and triggers, with distances in inches or degrees of turning
+         * @return Completion the motions of each side
+         */
+        Completion turnMotion(float target_angle, int max_speed, float exit_error, const MoveOptions& options = MoveOptions());
     
     public:
         /**
@@ -67,8 +81,29 @@ class Tank : public wpid::Chassis{
          * Chassis will always stay at or below the maximum speed.
          * @param distance the distance in inches
          * @param max_speed the maximum speed the robot will travel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(float distance, int max_speed) override;
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, with
+         * exit conditions and progress triggers checked on every tick.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param options the exit conditions and triggers, with distances in the same units as the distance
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(float distance, int max_speed, const MoveOptions& options) override;
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, returning
+         * as soon as it is within the chain tolerance without stopping.
+         * The next motion continues from the current speed, so a sequence like
+         * straightChained, turnChained, straight drives without braking between moves.
+         * @param distance the distance in inches
+         * @param max_speed the maximum speed the robot will travel in percent units
          */
-        void straightAsync(float distance, int max_speed) override;
+        void straightChained(float distance, int max_speed) override;
 
         /**
          * @brief Turn the chassis on the spot with PID.
@@ -83,8 +118,102 @@ class Tank : public wpid::Chassis{
          * Chassis will always stay at or below the maximum speed.
          * @param target_angle the target angle in degrees
          * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(float target_angle, int max_speed) override;
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, with exit conditions
+         * and progress triggers checked on every tick.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(float target_angle, int max_speed, const MoveOptions& options) override;
+
+        /**
+         * @brief Turn the chassis on the spot with PID, returning as soon as it is
+         * within the chain tolerance without stopping.
+         * The next motion continues from the current speed.
+         * @param target_angle the target angle in degrees
+         * @param max_speed the maximum speed in percent units
+         */
+        void turnChained(float target_angle, int max_speed) override;
+
+        /**
+         * @brief Move the chassis forward a specific distance with PID, using a typed length such as 24_in.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straight(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(Length distance, int max_speed);
+
+        /**
+         * @brief Move the chassis forward asynchronously a specific distance with PID, using a typed
+         * length, with exit conditions and progress triggers checked on every tick.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         * @param options the exit conditions and triggers, with distances in inches
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion straightAsync(Length distance, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Move the chassis forward without stopping at the end, using a typed length.
+         * @param distance the distance to travel
+         * @param max_speed the maximum speed the robot will travel in percent units
+         */
+        void straightChained(Length distance, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot with PID, using a typed angle such as 90_deg.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         */
+        void turn(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, using a typed angle.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         * @return Completion a handle to wait on or cancel the motion
          */
-        void turnAsync(float target_angle, int max_speed) override;
+        Completion turnAsync(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Turn the chassis on the spot asynchronously with PID, using a typed angle,
+         * with exit conditions and progress triggers checked on every tick.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         * @param options the exit conditions and triggers, with distances in degrees of turning
+         * @return Completion a handle to wait on or cancel the motion
+         */
+        Completion turnAsync(Angle target_angle, int max_speed, const MoveOptions& options);
+
+        /**
+         * @brief Turn the chassis on the spot without stopping at the end, using a typed angle.
+         * @param target_angle the angle to turn
+         * @param max_speed the maximum speed in percent units
+         */
+        void turnChained(Angle target_angle, int max_speed);
+
+        /**
+         * @brief Drive along a path without stopping at the waypoints using pure pursuit.
+         * The chassis steers along the arc to the lookahead point each tick, and the
+         * straight PID slows it down over the remaining length of the path.
+         * @param path the path to follow, starting at the robot's current pose
+         * @param max_speed the maximum speed in percent units
+         * @param lookahead the lookahead distance in inches
+         */
+        void followPath(const Path& path, int max_speed, float lookahead) override;
 
         /**
          * @brief Stops the chassis using the default brake mode.
@@ -132,6 +261,31 @@ class Tank : public wpid::Chassis{
          */
         void setMaxAcceleration(float max_accel);
 
+        /**
+         * @brief Turns on battery voltage compensation for every wheel,
+         * so motions take the same time on a fresh or drained battery.
+         * @param nominal the battery voltage 100 percent maps to in volts, or 0 to turn compensation off
+         */
+        void setVoltageCompensation(float nominal);
+
+        /**
+         * @brief Turns on thermal limiting for every wheel, so the drive slows down
+         * gradually as it heats up instead of the motor firmware cutting its power.
+         * @param start the temperature to start throttling at in celsius
+         * @param limit the temperature where the minimum scale is reached in celsius
+         * @param min_scale the lowest fraction of the output and current to allow
+         * @param max_current the current limit of each wheel's motors when they are cool in amps
+         */
+        void setThermalLimit(float start, float limit, float min_scale = 0.5, float max_current = 2.5);
+
+        /**
+         * @brief Runs every wheel's moves as a position loop cascaded into a faster
+         * velocity loop, which holds the wheel speeds more tightly under load.
+         * @param velocity_pid the velocity loop's gains, with a shorter delay time than the drive PIDs
+         * @param max_velocity the wheel rpm at 100 percent
+         */
+        void setCascade(PID velocity_pid, float max_velocity);
+
         /**
          * @brief Set the offset for the straight and turn functions.
          * This value is in inches, and will add to the input of each movement funciton.
@@ -140,6 +294,14 @@ class Tank : public wpid::Chassis{
          */
         void setOffset(float straight, float turn);
 
+        /**
+         * @brief Set how close a chained motion must get to its target before the next motion starts.
+         * Larger values blend motions together sooner, smaller values follow each motion more closely.
+         * @param straight the straight tolerance in inches
+         * @param turn the turn tolerance in degrees
+         */
+        void setChainTolerance(float straight, float turn);
+
         /**
          * @brief Set the timeout to use for PID movement. If the timeout is exceeded, 
          * the system will stop regardless of the current error or speed.
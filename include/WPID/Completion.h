@@ -0,0 +1,149 @@
+#pragma once
+#include "v5_vcs.h"
+#include <vector>
+#include "./Mechanism/MoveHandle.h"
+
+namespace wpid {
+/**
+ * @brief A handle to one or more motions that can be polled, waited on with a timeout,
+ * or combined with other completions using whenAll and whenAny.
+ * Every async motion returns one, so autonomous code can overlap a lift move with a drive
+ * and continue as soon as the motions it cares about are done.
+ */
+class Completion {
+    public:
+        /**
+         * @brief How the parts of a completion are combined.
+         */
+        enum class Mode {
+            /** @brief Done when every part is done */
+            ALL,
+            /** @brief Done when any part is done */
+            ANY
+        };
+
+    private:
+        /**
+        * How the parts are combined
+        */
+        Mode mode = Mode::ALL;
+
+        /**
+        * Mechanism moves that are part of this completion
+        */
+        std::vector<MoveHandle> moves;
+
+        /**
+        * Nested completions combined with a different mode
+        */
+        std::vector<Completion> children;
+
+        /**
+        * How often wait() checks the parts in milliseconds
+        */
+        static const int POLL_TIME = 1;
+
+        /**
+         * @brief Adds each part to a completion. Used to unpack whenAll and whenAny arguments.
+         */
+        static void addParts(Completion& completion) {}
+        template<class T, class... Rest>
+        static void addParts(Completion& completion, const T& first, const Rest&... rest){
+            completion.add(first);
+            addParts(completion, rest...);
+        }
+
+    public:
+        /**
+         * @brief Construct a completion for a single mechanism move.
+         * @param move the handle returned by a Mechanism async move
+         */
+        Completion(const MoveHandle& move);
+
+        /**
+         * @brief Construct an empty completion that combines parts with the given mode.
+         * An empty completion is always done.
+         * @param mode whether every part or any part must finish
+         */
+        Completion(Mode mode);
+        Completion() = default;
+
+        /**
+         * @brief Adds a mechanism move to this completion.
+         * @param move the handle returned by a Mechanism async move
+         * @return Completion& this completion, to add more parts
+         */
+        Completion& add(const MoveHandle& move);
+
+        /**
+         * @brief Adds a part to this completion. A part with the same mode is merged in,
+         * and an empty part counts as already done.
+         * @param part the motion to add
+         * @return Completion& this completion, to add more parts
+         */
+        Completion& add(const Completion& part);
+
+        /**
+         * @brief Checks if the motions are done without blocking.
+         * @return true once every part (ALL) or any part (ANY) is done
+         */
+        bool done() const;
+
+        /**
+         * @brief Blocks until the motions are done or the timeout passes.
+         * @param timeout the longest time to wait in milliseconds, or -1 to wait forever
+         * @return true if the motions finished, false if the timeout passed first
+         */
+        bool wait(int timeout = -1) const;
+
+        /**
+         * @brief Cancels every motion that is still running and stops its motors.
+         */
+        void cancel();
+
+        /**
+         * @brief Combines motions into a completion that is done when all of them are done.
+         * @param parts MoveHandles or Completions to wait on
+         * @return Completion the combined completion
+         */
+        template<class... T>
+        static Completion all(const T&... parts){
+            Completion completion = Completion(Mode::ALL);
+            addParts(completion, parts...);
+            return completion;
+        }
+
+        /**
+         * @brief Combines motions into a completion that is done when any of them is done.
+         * @param parts MoveHandles or Completions to wait on
+         * @return Completion the combined completion
+         */
+        template<class... T>
+        static Completion any(const T&... parts){
+            Completion completion = Completion(Mode::ANY);
+            addParts(completion, parts...);
+            return completion;
+        }
+};
+
+/**
+ * @brief Combines motions into a completion that is done when all of them are done.
+ * For example `whenAll(lift->moveAbsoluteAsync(90, 50), chassis->straightAsync(24, 60)).wait();`
+ * @param parts MoveHandles or Completions to wait on
+ * @return Completion the combined completion
+ */
+template<class... T>
+Completion whenAll(const T&... parts){
+    return Completion::all(parts...);
+}
+
+/**
+ * @brief Combines motions into a completion that is done when any of them is done.
+ * @param parts MoveHandles or Completions to wait on
+ * @return Completion the combined completion
+ */
+template<class... T>
+Completion whenAny(const T&... parts){
+    return Completion::any(parts...);
+}
+}
@@ -0,0 +1,279 @@
+#pragma once
+#include "v5.h"
+#include "v5_vcs.h"
+#include <vector>
+#include <atomic>
+#include "../Logger.h"
+#include "../Scheduler.h"
+#include "StateEstimator.h"
+
+namespace wpid {
+/**
+ * @brief Collects the motor commands made during a control tick and writes them together.
+ * Every mechanism attaches its motor group as a channel. Commands and current limits only
+ * update the channel, and a scheduler task flushes every channel once per period, skipping
+ * any write whose command or limit has not changed since it was last sent to the motors.
+ *
+ * The bus task also samples every channel once at the top of each period, and
+ * position, velocity and current reads are served from that snapshot, so every
+ * consumer in a tick sees the same time-aligned values. The devices are read without
+ * holding the bus lock, so a slow read never holds up a command or another channel's reading. Every reading also updates
+ * the channel's StateEstimator, which filters the encoder into a velocity and acceleration.
+ */
+class MotorBus {
+    public:
+        /**
+        * A reading of a motor group taken once per tick
+        */
+        struct Sample {
+            float position;          // degrees
+            float velocity;          // rpm, as reported by the motors
+            float filtered_velocity; // rpm, from the channel's state estimator
+            float acceleration;      // rpm per second, from the channel's state estimator
+            float current;           // amps
+            float temperature;       // celsius
+            float battery;           // volts, read once per tick for every channel
+            uint64_t time;           // microseconds, 0 before the first reading
+        };
+
+    private:
+        /**
+        * A command for a motor group
+        */
+        struct Command {
+            enum Type {NONE, VELOCITY, VOLTAGE, STOP};
+            Type type;
+            float value;
+            bool operator==(const Command& other) const {return type == other.type && value == other.value;}
+        };
+
+        /**
+        * A motor group, the newest command for it, and the last command sent
+        */
+        struct Channel {
+            vex::motor_group* motors;
+            Command pending;
+            Command written;
+            bool dirty;
+            Sample sample;
+            StateEstimator estimator;
+            uint32_t generation;  // bumped when the sample is thrown away, so a reading taken before is dropped
+            float limit;          // the newest current limit in amps, -1 until one is set
+            float written_limit;  // the current limit last sent to the motors
+        };
+
+        /**
+        * What the motors report, read without holding the bus lock
+        */
+        struct Reading {
+            float position;
+            float velocity;
+            float current;
+            float temperature;
+        };
+
+        /**
+        * The most channels, one motor group for every smart port
+        */
+        static const int MAX_CHANNELS = 21;
+
+        /**
+        * The attached motor groups, indexed by channel
+        */
+        std::vector<Channel> channels;
+
+        /**
+        * Guards the channels between the mechanism tasks and the bus task
+        */
+        vex::mutex lock;
+
+        /**
+        * Writes sent to the motors and writes skipped because nothing changed.
+        * Counted under the bus lock, read from any task without it
+        */
+        std::atomic<uint32_t> writes{0};
+        std::atomic<uint32_t> suppressed{0};
+
+        /**
+        * Channels read from the motors
+        */
+        std::atomic<uint32_t> reads{0};
+
+        /**
+        * The oldest sample that is served without reading the motors again, in microseconds
+        */
+        uint64_t max_age = 10000;
+
+        /**
+        * Battery voltage from the last reading
+        */
+        float battery = 0;
+
+        /**
+        * Reads the battery, without constructing a second brain
+        */
+        vex::brain::battery power;
+
+        /**
+        * Time between flushes in milliseconds
+        */
+        int period = 5;
+
+        /**
+        * The scheduler job that flushes the bus, added by the first attach
+        */
+        int job = -1;
+
+        MotorBus() = default;
+
+        /**
+         * @brief Samples and flushes the bus, called by the scheduler every period.
+         * @param data the bus
+         * @return true to keep running
+         */
+        static bool tick(void* data);
+
+        /**
+         * @brief Sends a command to a channel's motors if it differs from the last one sent.
+         * The bus lock must be held.
+         * @param channel the channel to write
+         */
+        void write(Channel& channel);
+
+        /**
+         * @brief Replaces the pending command of a channel.
+         * @param channel the channel returned by attach()
+         * @param command the command to send on the next flush
+         */
+        void command(int channel, Command command);
+
+        /**
+         * @brief Reads a motor group. Talks to the devices, so the bus lock must not be held.
+         * @param motors the motor group to read
+         * @return Reading what the motors report
+         */
+        static Reading measure(vex::motor_group* motors);
+
+        /**
+         * @brief Stores a reading in a channel's sample with the last battery reading, and
+         * updates its state estimator. Readings older than the sample are dropped.
+         * The bus lock must be held.
+         * @param channel the channel the reading was taken from
+         * @param reading what the motors reported
+         * @param now the time of the reading in microseconds
+         */
+        void store(Channel& channel, const Reading& reading, uint64_t now);
+
+    public:
+        /**
+         * @brief Gets the bus shared by every mechanism.
+         * @return MotorBus& the bus
+         */
+        static MotorBus& instance();
+
+        /**
+         * @brief Adds a motor group to the bus.
+         * @param motors the motor group to command
+         * @return int the channel to send commands to, or -1 if every channel is taken
+         */
+        int attach(vex::motor_group* motors);
+
+        /**
+         * @brief Sets the velocity of a channel, sent on the next flush.
+         * @param channel the channel returned by attach()
+         * @param velocity the velocity in velocityUnits::pct
+         */
+        void spin(int channel, float velocity);
+
+        /**
+         * @brief Sets the voltage of a channel, sent on the next flush.
+         * @param channel the channel returned by attach()
+         * @param volts the voltage in voltageUnits::volt
+         */
+        void spinVoltage(int channel, float volts);
+
+        /**
+         * @brief Sets the current limit of a channel's motors, sent on the next flush
+         * if it differs from the last limit sent.
+         * @param channel the channel returned by attach()
+         * @param amps the current limit in amps
+         */
+        void setCurrentLimit(int channel, float amps);
+
+        /**
+         * @brief Stops a channel with its brake mode.
+         * Stops are sent straight away instead of waiting for the next flush.
+         * @param channel the channel returned by attach()
+         */
+        void stop(int channel);
+
+        /**
+         * @brief Sends every changed command to the motors.
+         */
+        void flush();
+
+        /**
+         * @brief Reads every channel once, at the top of a tick.
+         * The bus task calls this every period. A control loop with its own tick may
+         * call it first so its readings line up with its tick.
+         */
+        void sample();
+
+        /**
+         * @brief Gets the latest reading of a channel.
+         * If the reading is older than the max age it is read again first.
+         * @param channel the channel returned by attach()
+         * @return Sample the reading
+         */
+        Sample getSample(int channel);
+
+        /**
+         * @brief Throws away a channel's reading so the next one comes from the motors,
+         * such as after the encoders are reset.
+         * @param channel the channel returned by attach()
+         */
+        void invalidate(int channel);
+
+        /**
+         * @brief Replaces the state estimator of a channel, which starts from the next reading.
+         * @param channel the channel returned by attach()
+         * @param estimator the estimator, such as StateEstimator::fromNoise(2000, 0.1, 5)
+         */
+        void setEstimator(int channel, const StateEstimator& estimator);
+
+        /**
+         * @brief Sets the oldest reading that is served from the snapshot.
+         * @param max_age the age in microseconds
+         */
+        void setMaxSampleAge(uint64_t max_age);
+
+        /**
+         * @brief Sets the time between flushes.
+         * @param period the time in milliseconds
+         */
+        void setPeriod(int period);
+
+        /**
+         * @brief Gets the number of commands sent to the motors.
+         * @return uint32_t the write count
+         */
+        uint32_t getWrites() const;
+
+        /**
+         * @brief Gets the number of flushed commands skipped because they matched the last one sent.
+         * @return uint32_t the suppressed count
+         */
+        uint32_t getSuppressed() const;
+
+        /**
+         * @brief Gets the number of times a channel was read from the motors.
+         * @return uint32_t the read count
+         */
+        uint32_t getReads() const;
+
+        /**
+         * @brief Resets the write, suppressed and read counters to 0.
+         */
+        void resetCounters();
+};
+}
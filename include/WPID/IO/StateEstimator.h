@@ -0,0 +1,115 @@
+#pragma once
+#include "stdint.h"
+#include <cmath>
+#include "../Logger.h"
+
+namespace wpid {
+/**
+ * @brief Estimates the position, velocity and acceleration of a motor group from its
+ * encoder readings with an alpha-beta-gamma filter, a Kalman filter for a constant
+ * acceleration model whose gains have been fixed at their steady state.
+ * Each reading moves the prediction towards the encoder by the residual times alpha
+ * for the position, beta for the velocity and gamma for the acceleration:
+ *
+ *     MotorBus::instance().setEstimator(channel, StateEstimator::fromNoise(2000, 0.1, 5));
+ *
+ * The motor bus runs one for every channel at the control rate, so settle detection,
+ * feedforward and telemetry all share the same filtered velocity.
+ */
+class StateEstimator {
+    private:
+        /**
+        * Correction gains for the position, velocity and acceleration
+        */
+        float alpha;
+        float beta;
+        float gamma;
+
+        /**
+        * The estimate in degrees, degrees per second and degrees per second squared
+        */
+        float position = 0;
+        float velocity = 0;
+        float acceleration = 0;
+
+        /**
+        * Time of the last reading in microseconds, 0 before the first reading
+        */
+        uint64_t last_time = 0;
+
+    public:
+        /**
+         * @brief Construct a new StateEstimator with the default fading memory of 0.7.
+         */
+        StateEstimator();
+
+        /**
+         * @brief Construct a new StateEstimator with its gains.
+         * Alpha and beta between 0 and 1 with a small gamma are stable, such as 0.5, 0.2, 0.02.
+         * @param alpha weight of the position residual, 1 to trust the encoder completely
+         * @param beta weight of the residual in the velocity
+         * @param gamma weight of the residual in the acceleration, 0 to only estimate velocity
+         */
+        StateEstimator(float alpha, float beta, float gamma);
+
+        /**
+         * @brief Builds an estimator that forgets older readings by a fixed factor each reading.
+         * This is a critically damped filter tuned by one number.
+         * @param theta how much of the old estimate to keep, from 0 for none to near 1 for heavy smoothing
+         * @return StateEstimator the estimator
+         */
+        static StateEstimator fadingMemory(float theta);
+
+        /**
+         * @brief Builds the steady state Kalman filter for a motor whose acceleration
+         * changes randomly, read by an encoder with random noise.
+         * A larger process noise follows changes faster, and a larger measurement noise smooths more.
+         * @param process_noise how quickly the acceleration can change, in degrees per second cubed per root hertz
+         * @param measurement_noise the standard deviation of an encoder reading in degrees
+         * @param period the time between readings in milliseconds, usually the motor bus period
+         * @return StateEstimator the estimator
+         */
+        static StateEstimator fromNoise(float process_noise, float measurement_noise, float period);
+
+        /**
+         * @brief Starts the estimate again at a position with no motion, such as after the encoders reset.
+         * @param position the position in degrees
+         * @param time the time of the reading in microseconds
+         */
+        void reset(float position, uint64_t time);
+
+        /**
+         * @brief Predicts the motion since the last reading and corrects it with a new reading.
+         * The first reading starts the estimate, and a reading that is not newer than the last is ignored.
+         * @param position the encoder position in degrees
+         * @param time the time of the reading in microseconds
+         */
+        void update(float position, uint64_t time);
+
+        /**
+         * @brief Gets the filtered position.
+         * @return float the position in degrees
+         */
+        float getPosition() const;
+
+        /**
+         * @brief Gets the filtered velocity.
+         * @return float the velocity in degrees per second
+         */
+        float getVelocity() const;
+
+        /**
+         * @brief Gets the filtered acceleration.
+         * @return float the acceleration in degrees per second squared
+         */
+        float getAcceleration() const;
+
+        /**
+         * @brief Gets the correction gains.
+         * @param alpha set to the position gain
+         * @param beta set to the velocity gain
+         * @param gamma set to the acceleration gain
+         */
+        void getGains(float& alpha, float& beta, float& gamma) const;
+};
+}
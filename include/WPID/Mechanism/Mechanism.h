@@ -3,20 +3,44 @@
 #include "v5_vcs.h"
 #include "../Logger.h"
 #include "../PID.h"
+#include "../Units.h"
+#include "../Registry.h"
+#include "MoveHandle.h"
+#include "MoveOptions.h"
+#include "StallDetector.h"
+#include "VelocityController.h"
+#include "../IO/MotorBus.h"
+#include "../Seqlock.h"
+#include "../Scheduler.h"
 #include <string>
+#include <atomic>
 
 namespace wpid{
+/**
+ * @brief What a mechanism was doing on its last control tick, published for other tasks.
+ */
+struct MechanismState {
+    float position = 0;    // degrees at the mechanism output
+    float target = 0;      // degrees, the target of the last move after the offset and bounds, or rpm for a velocity move
+    float error = 0;       // degrees from the target, or rpm for a velocity move
+    float output = 0;      // the commanded speed in velocityUnits::pct
+    MoveStatus phase = MoveStatus::IDLE; // RUNNING during a move, then how the last move ended
+    uint32_t move = 0;     // the id of the last move
+    uint32_t time = 0;     // milliseconds when the state was published
+};
+
 class Mechanism {
+friend class MoveHandle;
 private:
     /**
-    * Mechanism Name
+    * Mechanism motors
     */
-    std::string name = "Mechanism";
+    vex::motor_group* motors;
 
     /**
-    * Mechanism motors
+    * The motor bus channel commands are sent through
     */
-    vex::motor_group* motors;
+    int channel = -1;
 
     /**
     * The Gear ratio from motor to output
@@ -24,71 +48,339 @@ private:
     float gear_ratio;
 
     /**
-    * The PID Constants
+    * The PID run by the move thread. Its gains come from the published parameters
     */
     PID pid;
-    
+
+    /**
+    * The version of the published gains the move thread's PID is using
+    */
+    uint32_t pid_version = 0;
+
+    /**
+    * The inner velocity loop of a cascaded move, and the version of its gains
+    */
+    PID velocity_pid;
+    uint32_t velocity_version = 0;
+
+    /**
+    * The registry id the velocity loop logs under
+    */
+    int velocity_id = -1;
+
+    /**
+    * The controller a velocity move runs, built by the move thread from the published
+    * config, and the version it was built from. It keeps its state between velocity
+    * moves so a spinning flywheel isn't dropped
+    */
+    VelocityController velocity;
+    uint32_t velocity_run_version = 0;
+
+    /**
+    * Spin-up and recovery measurements published by velocity moves
+    */
+    Seqlock<VelocityMetrics> velocity_metrics;
+
+    /**
+    * Settings that may be changed from another task while a move is running.
+    * The move thread reads a whole copy at the top of every tick.
+    */
+    struct Params {
+        PIDConfig pid;              // gains and limits of the PID
+        uint32_t pid_version = 0;   // bumped every time the gains are set
+        float offset = 0;           // an offset to account for consistent error
+        float max_acceleration = 0; // the max acceleration of the mechanism
+        float upper_bound = MAXFLOAT;  // the upper bound to limit mechanism motion
+        float lower_bound = -MAXFLOAT; // the lower bound to limit mechanism motion
+        uint32_t limits_version = 0;   // bumped every time the offset or bounds are set
+        bool cascaded = false;         // true to run the position loop through a velocity loop
+        PIDConfig velocity_pid;        // gains of the velocity loop, error in rpm
+        uint32_t velocity_version = 0; // bumped every time the velocity gains are set
+        float max_velocity = 0;        // output rpm of the mechanism at 100 percent
+        VelocityConfig controller;     // the controller velocity moves run
+        uint32_t controller_version = 0; // bumped every time the velocity controller is set
+        float nominal_voltage = 0;     // the battery voltage 100 percent maps to, 0 to command percent output
+        float thermal_start = 0;       // celsius where the output starts to be scaled down, 0 when thermal limiting is off
+        float thermal_limit = 0;       // celsius where the output reaches the minimum scale
+        float thermal_min_scale = 1;   // the lowest the output is scaled to when the motors are hot
+        float max_current = 2.5;       // the current limit of the motors when they are cool in amps
+        uint32_t thermal_version = 0;  // bumped every time thermal limiting is set or turned off
+        bool stall_enabled = false;    // true to watch moves for a stall
+        int stall_window = 300;        // time the mechanism must be stuck in milliseconds
+        float stall_min_progress = 5;  // the least the position must change over the window in degrees
+        float stall_min_current = -1;  // the current that shows the motors are loaded in amps, -1 to ignore current
+        StallAction stall_action = StallAction::ABORT; // what a move does when the mechanism stalls
+        uint32_t stall_version = 0;    // bumped every time stall detection is set or turned off
+    };
+    Seqlock<Params> params;
+
+    /**
+    * The state published by the move thread every tick, its only writer
+    */
+    Seqlock<MechanismState> state;
+
+    /**
+    * The registry id of the mechanism's name for logging purposes
+    */
+    int mech_id = -1;
+
+    /**
+    * The scale applied to the output, 1 when the motors are not being throttled, and the
+    * version of the thermal settings it was worked out with
+    */
+    std::atomic<float> thermal_scale{1};
+    uint32_t thermal_version = 0;
+
     /**
-    * An offset to account for consistent error
+    * Watches each move for a stall, built by the move thread from the published settings,
+    * and the version it was built from
     */
-    float offset = 0;
+    StallDetector stall;
+    uint32_t stall_version = 0;
 
     /**
-    * The string identifier for the motor group for logging purposes
+    * True if the last move was chained and left the motors running
     */
-    std::string mech_id;
+    std::atomic<bool> chained{false};
 
     /**
-    * The Max acceleration of the mechanism
+    * The target of the last chained move, used as the start of the next relative move
     */
-    float max_acceleration = 0;
+    std::atomic<float> chain_target{0};
 
     /**
-    * The upper bound to limit mechanism motion
+    * The speed the last chained move left the motors running at in velocityUnits::pct
     */
-    float upper_bound = MAXFLOAT;
+    float carry_speed = 0;
+
     /**
-    * The lower bound to limit mechanism motion
+    * The move this mechanism is running. Fields that another task may touch are
+    * atomic, the rest, and the state, are only written by the move thread, or by a
+    * task that has claimed the mechanism while no move thread is scheduled.
     */
-    float lower_bound = -MAXFLOAT;
+    struct Move {
+        std::atomic<uint32_t> id{0};       // the newest move, ahead of ticking while it waits to take over
+        std::atomic<uint64_t> target{0};   // the target packed with its move's id, see packTarget
+        std::atomic<uint32_t> cancelled{0}; // the newest move id asked to stop
+        std::atomic<bool> done{true};   // false while a move thread is scheduled or the mechanism is claimed, see claim()
+        uint32_t ticking = 0;           // the id of the move the ticks are running
+        bool running = false;           // true from the first tick of a move until it finishes
+        int job_period = 0;             // milliseconds between runs of the scheduled move thread
+        float max_speed = 0;
+        float exit_error = -1;
+        float requested = 0;            // the target the setpoint was made from
+        float setpoint = 0;             // the target after the offset and bounds
+        float error = 999;
+        float ramp = 0;
+        int calculated_speed = 999;
+        int final_speed = 0;
+        uint32_t limits_version = 0;    // the offset and bounds the setpoint was made with
+        bool cascaded = false;          // true if the move runs through the velocity loop
+        bool velocity_mode = false;     // true if the target is a velocity in rpm
+        int period = 20;                // milliseconds between ticks
+        int outer_ticks = 1;            // ticks per run of the position loop
+        int countdown = 0;              // ticks until the position loop runs again
+        bool commanded = false;         // true once a tick has sent the motors an output
+        float start = 0;                // degrees where the move started
+        uint32_t start_time = 0;        // milliseconds when the move started
+        MoveOptions options;            // exit conditions and progress triggers
+        MechanismState published;       // the state published each tick
+    };
+    Move move;
 
     /**
-    * A struct to store position, speed and the pointer to this mechanism
+    * A move posted for the move thread to start. Its target is already in the move's packed target
     */
-    typedef struct params {
-        Mechanism* mech;
-        float pos;
-        float spd;
-    }params;
+    struct Request {
+        float max_speed;
+        float exit_error;
+        MoveOptions options;
+        bool velocity_mode;
+    };
+
+    /**
+    * Posted moves, indexed by move id. The id is 0 while the request is being written
+    * and the move's id once it is whole, so the move thread can copy it without a lock
+    */
+    struct Posted {
+        std::atomic<uint32_t> id{0};
+        Request request;
+    };
+
+    /**
+    * Final states of the last few moves, indexed by move id, RUNNING until they end
+    */
+    static const int HISTORY = 8;
+    std::atomic<MoveStatus> history[HISTORY] = {};
+    Posted requests[HISTORY];
+
+    /**
+     * @brief Posts a move for the move thread, scheduling one if the mechanism is idle.
+     * A running move hands over to it on its next tick. Never waits, so it is safe to
+     * call from a control tick, such as a trigger starting another mechanism.
+     * @param target the target in degrees, or rpm for a velocity move
+     * @param request the rest of the move
+     * @return MoveHandle a handle to the new move
+     */
+    MoveHandle start(float target, const Request& request);
+
+    /**
+     * @brief Copies a posted move, unless it is still being written or was overwritten.
+     * @param id the id of the move
+     * @param request set to the move
+     * @return true if the copy is whole
+     */
+    bool take(uint32_t id, Request& request);
+
+    /**
+     * @brief Sets up a posted move on the move thread before its first tick.
+     * @param id the id of the move
+     * @param request the move to run
+     */
+    void launch(uint32_t id, const Request& request);
+
+    /**
+     * @brief Schedules the move thread at a period.
+     * @param period milliseconds between runs
+     * @return true if it was scheduled, false if its rate group is full
+     */
+    bool schedule(int period);
 
     /**
-     * @brief Get an instance of a param struct pointer to pass to setTarget.
-     * Used as a helper funciton to pass multple parameters into a thread.
-     * @param position the position target
-     * @param speed the max speed
-     * @return params* a parameter pointer
+     * @brief Schedules a move thread for the posted moves unless one is already scheduled.
+     * If the rate group is full, the moves waiting to start are cancelled.
+     * @param velocity_mode true if the newest move is a velocity move, which sets the first period
      */
-    params* getParams(float position, float speed){
-        params* p = new params;
-        p->mech = this;
-        p->pos = position;
-        p->spd = speed;
-        return p;
-    }
+    void wake(bool velocity_mode);
 
     /**
-     * @brief Sets the target position of the mechanism.
-     * Uses the PID algorithm to determine speeds of the motors.
-     * This function is inaccessable and is used as a helper.
-     * @param args the parameter arguments to set the target
+     * @brief Claims the move state for a task other than the move thread, such as to publish
+     * spin() or stop(). Never waits.
+     * @return true if no move thread was scheduled and the state is now this task's until unclaim()
      */
-    static void spinToTarget(void* args);  
+    bool claim();
 
     /**
-     * @brief The main thread responsible for spinning the motors 
-     * and calculating speeds using PID.
+     * @brief Gives back the move state, scheduling a move thread for any move posted meanwhile.
      */
-    vex::thread* mech_thread;
+    void unclaim();
+
+    /**
+     * @brief Gives up the move thread once its move has finished, unless a move was
+     * posted after it last checked, which it then takes over on its next run.
+     * @return true to keep the move thread running
+     */
+    bool release();
+
+    /**
+     * @brief Gets the time between ticks of a move.
+     * @param params the parameters the move starts with
+     * @param velocity_mode true for a velocity move
+     * @param outer_ticks set to the ticks per run of the position loop
+     * @return int milliseconds between ticks
+     */
+    static int periodOf(const Params& params, bool velocity_mode, int& outer_ticks);
+
+    /**
+     * @brief Sets up a new position move on its first tick.
+     */
+    void begin();
+
+    /**
+     * @brief Sets up a new velocity move on its first tick.
+     */
+    void beginVelocity();
+
+    /**
+     * @brief The move thread. Starts the newest posted move, handing over from the
+     * running one, and runs a tick of it. Called by the scheduler every move period.
+     * @param args a pointer to the mechanism
+     * @return true to keep running, false once there is no move left to run
+     */
+    static bool run(void* args);
+
+    /**
+     * @brief Runs one tick of the move, using the PID algorithm to determine speeds of the motors.
+     * @param args a pointer to the mechanism running the move
+     * @return true to keep running, false once the move has finished
+     */
+    static bool tick(void* args);
+
+    /**
+     * @brief Runs one tick of a velocity move.
+     * @param args a pointer to the mechanism running the move
+     * @return true to keep running, false once the move has been cancelled
+     */
+    static bool velocityTick(void* args);
+
+    /**
+     * @brief Packs a target with the id of the move it belongs to, so a MoveHandle can
+     * check that its move is still running and change the target in one atomic step.
+     * @param id the id of the move
+     * @param target the target in degrees, or rpm for a velocity move
+     * @return uint64_t the id in the high half and the target's bits in the low half
+     */
+    static uint64_t packTarget(uint32_t id, float target);
+
+    /**
+     * @brief Gets the target back out of a packed target.
+     * @param packed a target from packTarget
+     * @return float the target
+     */
+    static float unpackTarget(uint64_t packed);
+
+    /**
+     * @brief Ends the move, stopping the motors unless it was chained or preempted.
+     * Only called from the move thread.
+     * @param result how the move ended
+     */
+    void finish(MoveStatus result);
+
+    /**
+     * @brief Adds the offset to a target and limits it to the bounds of the mechanism.
+     * @param position the requested target in degrees
+     * @param params the parameters of this tick
+     * @return float the target the PID drives to
+     */
+    float limitTarget(float position, const Params& params);
+
+    /**
+     * @brief Gives the move thread's PID the published gains if they have changed.
+     * Only called from the move thread.
+     * @param params the parameters of this tick
+     */
+    void applyPID(const Params& params);
+
+    /**
+     * @brief Sends a percent output to the motors, as a voltage scaled to the nominal
+     * battery voltage when voltage compensation is on.
+     * @param speed the output in velocityUnits::pct
+     * @param params the parameters of this tick
+     */
+    void output(float speed, const Params& params);
+
+    /**
+     * @brief Gets the output scale for a motor temperature, rounded down to a 5 percent step.
+     * @param temperature the motor temperature in celsius
+     * @param params the parameters of this tick
+     * @return float the scale, 1 below the start temperature
+     */
+    float thermalScaleAt(float temperature, const Params& params);
+
+    /**
+     * @brief Updates the thermal scale from the motor temperature, and sends a current
+     * limit scaled with it through the motor bus. The scale moves in 5 percent steps, and has
+     * to cool 2 degrees past a step before it is raised again so it doesn't flicker.
+     * @param temperature the motor temperature in celsius
+     * @param params the parameters of this tick
+     */
+    void updateThermalScale(float temperature, const Params& params);
+
+    /**
+     * @brief Stops the motors and forgets the speed and target left by a chained move.
+     * The caller publishes the state.
+     */
+    void halt();
     
 public:
     /**
@@ -96,7 +388,7 @@ public:
      * 
      * @param motors the motors used on the mechanism
      * @param gear_ratio the external gear ratio
-     * @param mech_id a string identifier for the mechanism to use during logging
+     * @param mech_id a name for the mechanism to use during logging, registered once here
      */
     Mechanism(vex::motor_group* motors, float gear_ratio, std::string mech_id);
     Mechanism(vex::motor_group* motors, float gear_ratio);
@@ -104,18 +396,20 @@ public:
 
     /**
      * @brief Spins the motor group at the specified velocity.
-     * Negative values will spin the motors backwards.
+     * Negative values will spin the motors backwards. While a move is running, the
+     * move takes the motors back on its next tick.
      * @param velocity the velocity of the mechanism in velocityUnits::pct
      */
     void spin(int velocity);
 
     /**
-     * @brief stops the motors using the default brake mode.
+     * @brief stops the motors using the default brake mode, cancelling any running move.
      */
     void stop();
 
     /**
      * @brief Waits for the mechanism to finish motion.
+     * Only the task that starts moves on a mechanism should wait on it.
      */
     void waitUntilSettled();
 
@@ -128,12 +422,42 @@ public:
     void moveRelative(float position, float max_speed);
 
     /**
-     * @brief Move the mechanism to a relative angle asynchronously
+     * @brief Move the mechanism to a relative angle asynchronously.
+     * If the previous move was chained, the angle is relative to that move's target
+     * so the exit tolerance does not build up over a chain.
      * 
      * @param position the relative angle to move to in degrees
      * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param exit_error if positive, the move ends without stopping once the error is within 
+     * this many degrees so the next move can continue at speed
+     * @return MoveHandle a handle to cancel or retarget the move
      */
-    void moveRelativeAsync(float position, float max_speed);
+    MoveHandle moveRelativeAsync(float position, float max_speed, float exit_error = -1);
+
+    /**
+     * @brief Move the mechanism to a relative angle asynchronously, with exit conditions
+     * and progress triggers checked on every tick.
+     * 
+     * @param position the relative angle to move to in degrees
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param options the exit conditions and triggers, with distances in degrees
+     * @param exit_error if positive, the move ends without stopping once the error is within 
+     * this many degrees so the next move can continue at speed
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle moveRelativeAsync(float position, float max_speed, const MoveOptions& options, float exit_error = -1);
+
+    /**
+     * @brief Move the mechanism to a relative angle, returning as soon as the error
+     * is within the exit error. The motors keep running, and the next move starts
+     * from the current speed instead of braking to zero.
+     * The last move of a chain should be a normal move so the mechanism settles.
+     * 
+     * @param position the relative angle to move to in degrees
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param exit_error the error in degrees at which the next move takes over
+     */
+    void moveRelativeChained(float position, float max_speed, float exit_error);
 
     /**
      * @brief Move the mechanism to an absolute angle.
@@ -144,21 +468,181 @@ public:
     void moveAbsolute(float position, float max_speed);
 
     /**
-     * @brief Move the mechanism to an absolute angle asynchronously
+     * @brief Move the mechanism to an absolute angle asynchronously.
+     * If a move is already running it is preempted on its next tick, and the new move
+     * continues from the current speed instead of stopping first. Never waits, so it
+     * can be called from a trigger or another control tick.
      * 
      * @param position the absolute angle to move to in degrees
      * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param exit_error if positive, the move ends without stopping once the error is within 
+     * this many degrees so the next move can continue at speed
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle moveAbsoluteAsync(float position, float max_speed, float exit_error = -1);
+
+    /**
+     * @brief Move the mechanism to an absolute angle asynchronously, with exit conditions
+     * and progress triggers checked on every tick.
+     * 
+     * @param position the absolute angle to move to in degrees
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param options the exit conditions and triggers, with distances in degrees
+     * @param exit_error if positive, the move ends without stopping once the error is within 
+     * this many degrees so the next move can continue at speed
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle moveAbsoluteAsync(float position, float max_speed, const MoveOptions& options, float exit_error = -1);
+
+    /**
+     * @brief Move the mechanism to an absolute angle, returning as soon as the error
+     * is within the exit error. The motors keep running, and the next move starts
+     * from the current speed instead of braking to zero.
+     * The last move of a chain should be a normal move so the mechanism settles.
+     * 
+     * @param position the absolute angle to move to in degrees
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param exit_error the error in degrees at which the next move takes over
+     */
+    void moveAbsoluteChained(float position, float max_speed, float exit_error);
+
+    /**
+     * @brief Sets the controller used by velocity moves. Takes effect on the next spinVelocity.
+     * @param controller the velocity controller, such as VelocityController::takeBackHalf(0.2, 0.01)
+     */
+    void setVelocityController(const VelocityController& controller);
+
+    /**
+     * @brief Holds the mechanism at a velocity with closed-loop control, such as for a flywheel.
+     * The move runs until it is cancelled, the mechanism is stopped, or another move starts.
+     * Calling it again while spinning changes the target without dropping the output,
+     * and retarget() on the handle changes the target velocity.
+     * 
+     * @param velocity the target velocity of the mechanism output in rpm
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle spinVelocity(float velocity);
+
+    /**
+     * @brief Gets the spin-up and recovery measurements of the velocity moves.
+     * @return VelocityMetrics a consistent copy of the metrics
+     */
+    VelocityMetrics getVelocityMetrics() const;
+
+    /**
+     * @brief Move the mechanism to a relative angle, using a typed angle such as 90_deg.
+     * 
+     * @param position the relative angle to move to
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     */
+    void moveRelative(Angle position, float max_speed);
+
+    /**
+     * @brief Move the mechanism to a relative angle asynchronously, using a typed angle.
+     * 
+     * @param position the relative angle to move to
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param exit_error if positive, the move ends without stopping once the error is within this angle
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle moveRelativeAsync(Angle position, float max_speed, Angle exit_error = Angle(-1));
+
+    /**
+     * @brief Move the mechanism to a relative angle asynchronously, using a typed angle, with
+     * exit conditions and progress triggers checked on every tick.
+     * 
+     * @param position the relative angle to move to
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param options the exit conditions and triggers, with distances in degrees
+     * @param exit_error if positive, the move ends without stopping once the error is within this angle
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle moveRelativeAsync(Angle position, float max_speed, const MoveOptions& options, Angle exit_error = Angle(-1));
+
+    /**
+     * @brief Move the mechanism to an absolute angle, using a typed angle such as 0.5_rev.
+     * 
+     * @param position the absolute angle to move to
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     */
+    void moveAbsolute(Angle position, float max_speed);
+
+    /**
+     * @brief Move the mechanism to an absolute angle asynchronously, using a typed angle.
+     * 
+     * @param position the absolute angle to move to
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param exit_error if positive, the move ends without stopping once the error is within this angle
+     * @return MoveHandle a handle to cancel or retarget the move
      */
-    void moveAbsoluteAsync(float position, float max_speed);
+    MoveHandle moveAbsoluteAsync(Angle position, float max_speed, Angle exit_error = Angle(-1));
+
+    /**
+     * @brief Move the mechanism to an absolute angle asynchronously, using a typed angle, with
+     * exit conditions and progress triggers checked on every tick.
+     * 
+     * @param position the absolute angle to move to
+     * @param max_speed the max speed of the motors in velocityUnits::pct
+     * @param options the exit conditions and triggers, with distances in degrees
+     * @param exit_error if positive, the move ends without stopping once the error is within this angle
+     * @return MoveHandle a handle to cancel or retarget the move
+     */
+    MoveHandle moveAbsoluteAsync(Angle position, float max_speed, const MoveOptions& options, Angle exit_error = Angle(-1));
     
     /**
      * @brief Get the position of the first motor in the group with the specified units.
+     * Degrees and revolutions come from the motor bus snapshot of this tick.
      * 
      * @param units the rotation units to return
      * @return float the position of the motor
      */
     float getPosition(vex::rotationUnits units);
 
+    /**
+     * @brief Get the velocity of the mechanism from the motor bus snapshot of this tick.
+     * 
+     * @param units the velocity units to return, rpm or dps. Other units are read from the motors.
+     * @return float the velocity of the mechanism
+     */
+    float getVelocity(vex::velocityUnits units);
+
+    /**
+     * @brief Get the velocity of the mechanism from the state estimator, which is smoother
+     * than the velocity the motors report and follows changes sooner than a slower filter.
+     * 
+     * @return float the velocity of the mechanism output in rpm
+     */
+    float getFilteredVelocity();
+
+    /**
+     * @brief Get the acceleration of the mechanism from the state estimator.
+     * 
+     * @return float the acceleration of the mechanism output in rpm per second
+     */
+    float getAcceleration();
+
+    /**
+     * @brief Sets how the encoder readings are filtered into a velocity and acceleration.
+     * 
+     * @param estimator the estimator, such as StateEstimator::fromNoise(2000, 0.1, 5)
+     */
+    void setEstimator(const StateEstimator& estimator);
+
+    /**
+     * @brief Get the current drawn by the motors from the motor bus snapshot of this tick.
+     * 
+     * @return float the current in amps
+     */
+    float getCurrent();
+
+    /**
+     * @brief Gets what the mechanism was doing on its last control tick.
+     * This only copies the state the control loop already published, so any task
+     * may call it as often as it likes without reading the motors or slowing the loop.
+     * @return MechanismState a consistent copy of the state
+     */
+    MechanismState getState() const;
+
     /**
      * @brief Resets the encoders in the group to 0.
      */
@@ -172,10 +656,30 @@ public:
 
     /**
      * @brief Set a PID object to the mechanism.
+     * The gains may be changed while a move is running, such as to tune from the
+     * controller, and the move picks them up at the start of its next tick.
      * @param PID a PID object
      */
     void setPID(PID pid);
 
+    /**
+     * @brief Runs moves as a cascade. The position PID's speed becomes a velocity
+     * setpoint, and a faster inner loop drives the motors to that velocity from the
+     * measured motor velocity, with the setpoint fed forward. This tracks the
+     * position loop more tightly under load, and usually settles faster.
+     * The inner loop runs at the velocity PID's delay time, so give it a shorter delay
+     * than the position PID, such as 5 ms against 20 ms.
+     * Takes effect on the next move, gains may be changed during a move.
+     * @param velocity_pid the velocity loop's gains, from rpm of error to percent output
+     * @param max_velocity the output rpm of the mechanism at 100 percent, such as 200 for a green cartridge with no external gearing
+     */
+    void setCascade(PID velocity_pid, float max_velocity);
+
+    /**
+     * @brief Goes back to driving the motors straight from the position PID on the next move.
+     */
+    void disableCascade();
+
     /**
      * @brief Set the offset of the mechanism to add or subtract a constant angle.
      * 
@@ -192,6 +696,59 @@ public:
      */
     void setMaxAcceleration(float max_accel);
 
+    /**
+     * @brief Turns on battery voltage compensation.
+     * Outputs are sent as a voltage, with 100 percent mapped to the nominal voltage
+     * instead of to whatever the battery has left, so a move takes the same time on a
+     * fresh or drained battery and tuned gains and timeouts stay valid.
+     * Pick a nominal voltage the battery can still reach at the end of a match.
+     * @param nominal the battery voltage 100 percent maps to in volts, or 0 to turn compensation off
+     */
+    void setVoltageCompensation(float nominal);
+
+    /**
+     * @brief Turns on thermal limiting, so a mechanism that heats up over a long practice
+     * slows down gradually instead of the motor firmware cutting its power.
+     * Above the start temperature the output and the current limit are scaled down
+     * linearly, reaching the minimum scale at the limit temperature.
+     * V5 motors start halving their own current at 55 degrees celsius.
+     * @param start the temperature to start throttling at in celsius
+     * @param limit the temperature where the minimum scale is reached in celsius
+     * @param min_scale the lowest fraction of the output and current to allow
+     * @param max_current the current limit of the motors when they are cool in amps
+     */
+    void setThermalLimit(float start, float limit, float min_scale = 0.5, float max_current = 2.5);
+
+    /**
+     * @brief Turns off thermal limiting and restores the current limit.
+     */
+    void disableThermalLimit();
+
+    /**
+     * @brief Gets the fraction of the output the mechanism is limited to because of temperature.
+     * @return float 1 when not throttling, down to the minimum scale
+     */
+    float getThermalScale();
+
+    /**
+     * @brief Turns on stall detection, so a move that is pushing against a hard stop or
+     * a wall ends early instead of waiting for the timeout. The mechanism is stalled when,
+     * for the whole window, it is driven at 10 percent or more but moves less than the
+     * minimum progress at under 5 rpm, and draws at least the minimum current if one is set.
+     * @param window the time the mechanism must be stuck in milliseconds, up to 64 PID ticks.
+     * A longer window is reduced to 64 ticks of the PID set when this is called, so set the PID first
+     * @param min_progress the least the mechanism must move over the window in degrees
+     * @param min_current the current that shows the motors are loaded in amps, or -1 to ignore current
+     * @param action ABORT to end the move as STALLED, or COMPLETE to end it as SETTLED.
+     * Takes effect on the next move
+     */
+    void setStallDetection(int window, float min_progress, float min_current = -1, StallAction action = StallAction::ABORT);
+
+    /**
+     * @brief Turns off stall detection. Takes effect on the next move.
+     */
+    void disableStallDetection();
+
     /**
      * @brief Set the bounds of the mechanism, such that it is unable to spin past these points.
      * This check is only done during driver control and does not affect PID motion. 
@@ -0,0 +1,87 @@
+#pragma once
+#include "stdint.h"
+
+namespace wpid {
+class Mechanism;
+
+/**
+ * @brief The state of a move started on a Mechanism.
+ */
+enum class MoveStatus {
+    /** @brief The handle does not refer to a move */
+    IDLE,
+    /** @brief The move is still running */
+    RUNNING,
+    /** @brief The move finished within its error range */
+    SETTLED,
+    /** @brief The move reached its exit error and left the motors running for the next move */
+    CHAINED,
+    /** @brief The move ran out of time before settling */
+    TIMED_OUT,
+    /** @brief The move was cancelled and the motors were stopped */
+    CANCELLED,
+    /** @brief A newer move on the same mechanism took over without stopping the motors */
+    PREEMPTED,
+    /** @brief The mechanism stopped making progress, such as against a hard stop or a wall */
+    STALLED,
+    /** @brief An exit condition from the move's options ended it and the motors were stopped */
+    EXITED
+};
+
+/**
+ * @brief A handle to a move started by one of the Mechanism async functions.
+ * The Mechanism owns the move and the thread running it; a handle is only a small
+ * value that can be copied freely and used from any task. Starting a new move on a
+ * mechanism preempts the running one, after which older handles become inactive
+ * and cancel() and retarget() do nothing.
+ */
+class MoveHandle {
+    private:
+        /**
+        * The mechanism running the move
+        */
+        Mechanism* mech = nullptr;
+
+        /**
+        * The id of the move on that mechanism
+        */
+        uint32_t id = 0;
+
+    public:
+        /**
+         * @brief Construct a new MoveHandle object.
+         * @param mech the mechanism running the move
+         * @param id the id the mechanism gave the move
+         */
+        MoveHandle(Mechanism* mech, uint32_t id) : mech(mech), id(id){};
+        MoveHandle() = default;
+
+        /**
+         * @brief Checks if the move is still running.
+         * @return true while the move is running
+         */
+        bool active() const;
+
+        /**
+         * @brief Gets the state of the move.
+         * Only the last few moves on a mechanism are remembered, so very old handles report IDLE.
+         * @return MoveStatus the state of the move
+         */
+        MoveStatus status() const;
+
+        /**
+         * @brief Stops the move on its next tick and stops the motors.
+         * Does nothing if the move has already finished.
+         */
+        void cancel();
+
+        /**
+         * @brief Changes the absolute target of the move while it is running.
+         * The PID keeps its integral and derivative filter, and the timeout still
+         * counts from the start of the move.
+         * @param position the new absolute target in degrees
+         * @return true if the move was still running and was retargeted
+         */
+        bool retarget(float position);
+};
+}
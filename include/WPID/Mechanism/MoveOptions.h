@@ -0,0 +1,153 @@
+#pragma once
+#include "stdint.h"
+#include <cmath>
+#include "../Logger.h"
+#include "MoveHandle.h"
+
+namespace wpid {
+/**
+ * @brief Exit conditions and progress triggers for a move, checked on every control tick.
+ * An exit condition ends the move early and stops the motors, and a trigger runs a
+ * callback once when the move has travelled a distance, reached a fraction of its
+ * distance, or run for a time, so overlapping actions start at the right moment:
+ *
+ *     bool seesWall(void*) {return wallSensor.objectDistance(mm) < 100;}
+ *     void startIntake(void*) {intake.spin(100);}
+ *
+ *     chassis->straightAsync(36, 80, MoveOptions().exitWhen(seesWall).atFraction(0.6, startIntake));
+ *
+ * Conditions and callbacks run inside the control tick, so they must be quick and must
+ * never wait, such as on waitUntilSettled() or a blocking move. Starting an async move is
+ * fine, even on a mechanism that is already moving. Triggers the move never reaches do not run.
+ */
+class MoveOptions {
+    public:
+        /**
+        * Checks whether a move should end, given the data passed with it
+        */
+        typedef bool (*ExitCondition)(void* data);
+
+        /**
+        * Runs when a move reaches a trigger, given the data passed with it
+        */
+        typedef void (*Callback)(void* data);
+
+        /**
+        * The most exit conditions and triggers one move holds
+        */
+        static const int MAX_CONDITIONS = 4;
+        static const int MAX_TRIGGERS = 8;
+        static const int MAX_LINKED = 4;
+
+    private:
+        /**
+        * What a trigger measures its progress in
+        */
+        enum class Progress {DISTANCE, FRACTION, TIME};
+
+        struct Condition {
+            ExitCondition condition;
+            void* data;
+        };
+
+        struct Trigger {
+            Progress progress;
+            float at;           // distance, fraction or milliseconds
+            Callback callback;
+            void* data;
+            bool fired;
+        };
+
+        Condition conditions[MAX_CONDITIONS] = {};
+        int condition_count = 0;
+
+        Trigger triggers[MAX_TRIGGERS] = {};
+        int trigger_count = 0;
+
+        MoveHandle linked[MAX_LINKED];
+        int linked_count = 0;
+
+        /**
+         * @brief Adds a trigger, warning if the options are full.
+         * @return MoveOptions& these options, to add more
+         */
+        MoveOptions& trigger(Progress progress, float at, Callback callback, void* data);
+
+    public:
+        MoveOptions() = default;
+
+        /**
+         * @brief Ends the move as soon as a condition returns true. The motors are
+         * stopped and the move reports EXITED.
+         * @param condition the check to run every tick
+         * @param data passed to the check, such as a sensor
+         * @return MoveOptions& these options, to add more
+         */
+        MoveOptions& exitWhen(ExitCondition condition, void* data = nullptr);
+
+        /**
+         * @brief Runs a callback once the move has travelled a distance towards its target.
+         * @param distance the distance in degrees for a mechanism, or in the chassis units of the motion
+         * @param callback the function to run
+         * @param data passed to the callback
+         * @return MoveOptions& these options, to add more
+         */
+        MoveOptions& atDistance(float distance, Callback callback, void* data = nullptr);
+
+        /**
+         * @brief Runs a callback once the move has travelled a fraction of the way to its target.
+         * @param fraction the fraction of the distance, such as 0.6 for 60 percent
+         * @param callback the function to run
+         * @param data passed to the callback
+         * @return MoveOptions& these options, to add more
+         */
+        MoveOptions& atFraction(float fraction, Callback callback, void* data = nullptr);
+
+        /**
+         * @brief Runs a callback once the move has run for a time.
+         * @param time the time since the move started in milliseconds
+         * @param callback the function to run
+         * @param data passed to the callback
+         * @return MoveOptions& these options, to add more
+         */
+        MoveOptions& afterTime(int time, Callback callback, void* data = nullptr);
+
+        /**
+         * @brief Gets a copy with every distance trigger multiplied, such as to turn
+         * chassis inches into wheel degrees.
+         * @param factor the number to multiply distances by
+         * @return MoveOptions the scaled options
+         */
+        MoveOptions scaled(float factor) const;
+
+        /**
+         * @brief Cancels another move when an exit condition ends this one, so moves
+         * running alongside it stop with it, such as the other wheels of a drive.
+         * @param move the move to cancel
+         * @return MoveOptions& these options, to add more
+         */
+        MoveOptions& cancelOnExit(const MoveHandle& move);
+
+        /**
+         * @brief Cancels the moves linked with cancelOnExit. Called by the move when an
+         * exit condition ends it.
+         */
+        void cancelLinked();
+
+        /**
+         * @brief Checks if there is nothing to run.
+         * @return true if there are no exit conditions or triggers
+         */
+        bool empty() const;
+
+        /**
+         * @brief Runs the triggers that have been reached, then the exit conditions.
+         * Called by the move every tick.
+         * @param travelled the distance moved towards the target in degrees
+         * @param total the distance from the start to the target in degrees
+         * @param elapsed the time since the move started in milliseconds
+         * @return true if an exit condition wants the move to end
+         */
+        bool update(float travelled, float total, uint32_t elapsed);
+};
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "stdint.h"
+#include <cmath>
+
+namespace wpid {
+/**
+ * @brief What a move does when its mechanism stalls.
+ */
+enum class StallAction {
+    /** @brief Stop the motors and end the move as STALLED */
+    ABORT,
+    /** @brief Stop the motors and end the move as SETTLED, such as when homing against a hard stop */
+    COMPLETE
+};
+
+/**
+ * @brief Detects a stalled or obstructed mechanism from its recent readings.
+ * The mechanism is stalled when, over the whole window, it was being driven but
+ * barely moved, its velocity stayed low, and its current stayed high if a current
+ * threshold is set.
+ */
+class StallDetector {
+    public:
+        /**
+        * One tick of readings
+        */
+        struct Reading {
+            uint32_t time;     // milliseconds
+            float position;    // degrees
+            float velocity;    // rpm
+            float current;     // amps
+            float command;     // velocityUnits::pct
+        };
+
+        /**
+        * The most readings kept, which limits the window to CAPACITY ticks
+        */
+        static const int CAPACITY = 64;
+
+    private:
+        /**
+        * Ring buffer of the latest readings
+        */
+        Reading readings[CAPACITY];
+        int head = 0;
+        int count = 0;
+
+        /**
+        * False until configured with setStallDetection on the mechanism
+        */
+        bool enabled = false;
+
+        /**
+        * Time the mechanism must be stuck before it counts as stalled in milliseconds
+        */
+        int window = 300;
+
+        /**
+        * The least the position must change over the window in degrees
+        */
+        float min_progress = 5;
+
+        /**
+        * The velocity below which the mechanism is considered stopped in rpm
+        */
+        float max_velocity = 5;
+
+        /**
+        * The current at or above which the motors are considered loaded in amps, -1 to ignore current
+        */
+        float min_current = -1;
+
+        /**
+        * The least output that counts as trying to move in velocityUnits::pct
+        */
+        float min_command = 10;
+
+    public:
+        StallDetector() = default;
+
+        /**
+         * @brief Construct a new StallDetector object.
+         * @param window the time the mechanism must be stuck in milliseconds
+         * @param min_progress the least the position must change over the window in degrees
+         * @param min_current the current at or above which the motors are loaded in amps, or -1 to ignore current
+         */
+        StallDetector(int window, float min_progress, float min_current)
+            : enabled(true), window(window), min_progress(min_progress), min_current(min_current){};
+
+        /**
+         * @brief Set the velocity below which the mechanism is considered stopped.
+         * @param max_velocity the velocity in rpm
+         */
+        void setMaxVelocity(float max_velocity) {this->max_velocity = max_velocity;}
+
+        /**
+         * @brief Set the least output that counts as trying to move.
+         * @param min_command the output in velocityUnits::pct
+         */
+        void setMinCommand(float min_command) {this->min_command = min_command;}
+
+        /**
+         * @brief Checks if stall detection is on.
+         * @return true if the detector was configured
+         */
+        bool isEnabled() const {return enabled;}
+
+        /**
+         * @brief Clears the window, called at the start of every move.
+         */
+        void reset() {head = 0; count = 0;}
+
+        /**
+         * @brief Adds a tick of readings and checks for a stall.
+         * @param reading the readings of this tick
+         * @return true if the mechanism has been stalled for the whole window
+         */
+        bool update(const Reading& reading);
+};
+}
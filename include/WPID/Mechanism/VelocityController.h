@@ -0,0 +1,191 @@
+#pragma once
+#include "stdint.h"
+#include <cmath>
+#include "../PID.h"
+
+namespace wpid {
+/**
+ * @brief How a velocity controlled mechanism picks its output.
+ */
+enum class VelocityStrategy {
+    /** @brief Feedforward for the target velocity, corrected by a PID on the velocity error */
+    FEEDFORWARD_PID,
+    /** @brief Integrates the error, halving back to the last crossing each time the target is crossed */
+    TAKE_BACK_HALF,
+    /** @brief Full power below the target band, nothing above it, and the feedforward inside it */
+    BANG_BANG
+};
+
+/**
+ * @brief Spin-up and recovery measurements of a velocity controlled mechanism.
+ */
+struct VelocityMetrics {
+    float velocity = 0;         // filtered rpm
+    float target = 0;           // rpm
+    bool ready = false;         // true while the velocity is within the tolerance of the target
+    uint32_t spin_up_time = 0;  // milliseconds from the last target change to first reaching it, 0 until then
+    uint32_t recovery_time = 0; // milliseconds the last recovery took, from leaving the tolerance to returning
+    uint32_t recoveries = 0;    // times the velocity was knocked out of the tolerance and recovered, such as by a shot
+};
+
+/**
+ * @brief The gains and settings of a velocity controller, plain values that can be
+ * handed to the control loop without sharing any of the controller's run state.
+ */
+struct VelocityConfig {
+    VelocityStrategy strategy = VelocityStrategy::FEEDFORWARD_PID;
+    float kv = 0;         // percent output per rpm of target
+    float ks = 0;         // percent output to overcome friction
+    PIDConfig pid;        // the velocity PID, error in rpm and output in percent, not logged unless setLogging is called
+    float tbh_gain = 0;   // percent output added per rpm of error each tick for take back half
+    float band = 10;      // half width of the bang-bang band in rpm
+    float tolerance = 10; // the ready tolerance in rpm
+    float alpha = 0.5;    // weight of the newest estimate in the velocity filter
+    int period = 5;       // time between updates in milliseconds
+};
+
+/**
+ * @brief Closed-loop velocity control for flywheel-style mechanisms.
+ * The velocity is estimated from encoder deltas and smoothed with a low pass filter,
+ * and the output never reverses the motors, so a fast flywheel coasts down instead of
+ * braking against itself:
+ *
+ *     shooter->setVelocityController(VelocityController::takeBackHalf(0.3, 0.02));
+ *     shooter->spinVelocity(450);
+ */
+class VelocityController {
+    private:
+        /**
+        * The gains and settings
+        */
+        VelocityConfig config;
+
+        /**
+        * The velocity PID built from the config's gains
+        */
+        PID pid;
+
+        // run state
+        float filtered = 0;
+        float last_position = 0;
+        uint64_t last_time = 0;
+        float output = 0;
+        float tbh = 0;
+        float last_error = 0;
+        float target = 0;
+        uint32_t target_time = 0;
+        uint32_t drop_time = 0;
+        bool reached = false;
+        VelocityMetrics metrics;
+
+    public:
+        VelocityController() = default;
+
+        /**
+         * @brief Construct a new VelocityController object with a fresh run.
+         * @param config the gains and settings
+         */
+        VelocityController(const VelocityConfig& config);
+
+        /**
+         * @brief Feedforward plus PID, the most accurate once tuned.
+         * Updates at the PID's delay time. A velocity move never settles, so the PID's
+         * ticks are not logged unless setLogging turns it back on.
+         * @param kv percent output per rpm of target velocity
+         * @param ks percent output to overcome friction
+         * @param pid the correction, error in rpm and output in percent
+         * @return VelocityController the controller
+         */
+        static VelocityController feedforwardPID(float kv, float ks, PID pid);
+
+        /**
+         * @brief Take back half, which spins up with little overshoot and needs only one gain.
+         * @param kv percent output per rpm, used as the first guess of the output for a target
+         * @param gain percent output added per rpm of error each tick
+         * @return VelocityController the controller
+         */
+        static VelocityController takeBackHalf(float kv, float gain);
+
+        /**
+         * @brief Bang-bang, the fastest spin-up and recovery at the cost of some ripple.
+         * @param kv percent output per rpm, held while inside the band
+         * @param band the half width of the band around the target in rpm
+         * @return VelocityController the controller
+         */
+        static VelocityController bangBang(float kv, float band);
+
+        /**
+         * @brief Sets the low pass filter on the velocity estimate.
+         * @param alpha weight of the newest estimate, 1 for no filtering
+         */
+        void setFilter(float alpha);
+
+        /**
+         * @brief Sets how close the velocity must be to the target to count as ready.
+         * @param tolerance the tolerance in rpm
+         */
+        void setTolerance(float tolerance);
+
+        /**
+         * @brief Writes the feedforward PID's ticks to the log, such as while tuning.
+         * Every tick of a spinning flywheel is logged, so leave it off in a match.
+         * @param enabled true to log ticks
+         */
+        void setLogging(bool enabled);
+
+        /**
+         * @brief Sets the time between updates.
+         * @param period the time in milliseconds
+         */
+        void setPeriod(int period);
+
+        /**
+         * @brief Gets the time between updates.
+         * @return int the time in milliseconds
+         */
+        int getPeriod() const;
+
+        /**
+         * @brief Gets the gains and settings of the controller.
+         * @return const VelocityConfig& the config
+         */
+        const VelocityConfig& getConfig() const;
+
+        /**
+         * @brief Starts a run, keeping the output so a spinning flywheel isn't dropped.
+         * @param target the target velocity in rpm
+         * @param now the time in milliseconds
+         */
+        void start(float target, uint32_t now);
+
+        /**
+         * @brief Estimates the velocity from the change in position since the last reading.
+         * @param position the position in degrees
+         * @param time the time of the reading in microseconds
+         * @param measured the velocity the motors report in rpm, used for the first reading
+         * @return float the filtered velocity in rpm
+         */
+        float estimate(float position, uint64_t time, float measured);
+
+        /**
+         * @brief Calculates the output for a tick and updates the metrics.
+         * @param target the target velocity in rpm
+         * @param velocity the filtered velocity in rpm
+         * @param now the time in milliseconds
+         * @param id the registry id to log the PID under
+         * @return float the output in velocityUnits::pct
+         */
+        float update(float target, float velocity, uint32_t now, int id);
+
+        /**
+         * @brief Ends a run and writes the PID log.
+         */
+        void finish();
+
+        /**
+         * @brief Gets the spin-up and recovery measurements.
+         * @return const VelocityMetrics& the metrics
+         */
+        const VelocityMetrics& getMetrics() const;
+};
+}
@@ -1,101 +1,107 @@
 #pragma once
 #include "v5_vcs.h"
 #include "stdint.h"
-#include <sstream>
 #include <cmath>
 #include <math.h>
-#include <iomanip>
-#include <fstream>
+#include <memory>
 #include "./Logger.h"
+#include "./Registry.h"
+#include "./PIDLogger.h"
 
 namespace wpid{
-class PID {
-    private:
-        // PID constants
-        /**
-        * Proportional Constant
-        */
-        float kp;
+/**
+ * @brief The gains and limits of a PID controller. A config is shared between every
+ * controller made from it and is never changed once shared, so copying a controller
+ * for a new move only copies a pointer.
+ */
+struct PIDConfig {
+    float kp = 0;                 // proportional constant
+    float ki = 0;                 // integral constant
+    float kd = 0;                 // derivative constant
+    float bound = 2;              // error bound in rotationUnits::deg
+    int delay_time = 20;          // loop delay in milliseconds
+    int bias = 0;                 // lowest speed in velocityUnits::pct
+    int low_speed_threshold = 2;  // speed below which the system is slow enough to stop
+    int timeout = -1;             // longest a run may take in milliseconds, -1 for none
+    int max_integral_speed = 100; // largest output of the integral term in velocityUnits::pct
+    float settle_error = -1;      // error band for settling on measured motion in rotationUnits::deg, -1 to use the bound and low speed threshold
+    float settle_velocity = 5;    // measured speed below which the system is still in degrees per second
+    int settle_time = 0;          // time the system must stay in the settle band in milliseconds
+    bool telemetry = false;       // true to add the telemetry columns to the log
+    bool logging = true;          // true to write every tick to the log
+};
 
-        /**
-        * Integral Constant
-        */
-        float ki;
-
-        /**
-        * Derivative Constant
-        */
-        float kd;
+/**
+ * @brief The values a PID controller carries from one tick of a run to the next.
+ */
+struct PIDState {
+    float prev_error = MAXFLOAT;  // the previous error
+    float prev_integral = 0;      // the previous integral
+    float previous_estimate = 0;  // the previous filtered derivative
+    int start_time = -1;          // the start time of the run, -1 before the first tick
+    int settle_start = -1;        // when the system entered the settle band, -1 while outside it
+};
 
-        // Stored values
+class PID {
+    private:
         /**
-        * The Previous Error
+        * The shared gains and limits. Setters replace it with a changed copy
         */
-        float prev_error = MAXFLOAT;
+        std::shared_ptr<const PIDConfig> config = defaults();
 
         /**
-        * The Previous Integral
-        */
-        float prev_integral = 0;
-
-        /*
-        * The previous estimate for the derivative term 
+        * The state of the current run
         */
-        float previous_estimate = 0;
+        PIDState state;
 
-        /*
-        * The starting time for a PID run
-        */
-        int start_time = -1;
-
-        // Tuneable attributes
         /**
-        * The error bound in rotationUnits::deg
-        */
-        float bound = 2;
+         * @brief Gets the config shared by every PID made without constants.
+         * @return std::shared_ptr<const PIDConfig> the default config
+         */
+        static std::shared_ptr<const PIDConfig> defaults(void);
 
         /**
-        * PID loop delay in milliseconds
-        */
-        int delay_time = 20;
+         * @brief Gets a private copy of the config to change, leaving any controller
+         * sharing the old config untouched.
+         * @return PIDConfig& the copy, now used by this controller
+         */
+        PIDConfig& edit(void);
 
+    public:       
         /**
-        * Lowest speed possible for the PID to achieve
-        */
-        int bias = 0; 
+         * @brief Construct a new PID object.
+         * When constructing a PID object, only the kp constant is required, 
+         * ki and kd can be set to 0 if not used.
+         * @param kp proportional constant
+         * @param ki integral constant
+         * @param kd derrivative constant
+         */
+        PID(float kp, float ki, float kd);
+        PID() = default;
 
         /**
-         * A threshold to check for when the system is slow enough to stop
+         * @brief Construct a new PID object from a config.
+         * @param config the gains and limits, copied once and shared by every copy of this PID
          */
-        int low_speed_threshold = 2;
+        PID(const PIDConfig& config);
 
         /**
-         * The timeout in milliseconds for how long a movement should take. 
-         * Will stop the movement regardless of error when timeout is exceeded.
+         * @brief Construct a new PID object that shares an existing config.
+         * @param config the gains and limits
          */
-        int timeout = -1;
+        PID(std::shared_ptr<const PIDConfig> config);
 
         /**
-         * The maximum output of the integral term. Unit is velocityUnits::pct
+         * @brief Gets the gains and limits of the controller.
+         * @return const PIDConfig& the config
          */
-        int max_integral_speed = 100;
+        const PIDConfig& getConfig(void) const;
 
         /**
-        * Base name of the logging file
-        */
-        std::string fName = "LoggedData";
-        
-    public:       
-        /**
-         * @brief Construct a new PID object.
-         * When constructing a PID object, only the kp constant is required, 
-         * ki and kd can be set to 0 if not used.
-         * @param kp proportional constant
-         * @param ki integral constant
-         * @param kd derrivative constant
+         * @brief Replaces the gains and limits, keeping the state of the current run.
+         * @param config the new gains and limits
          */
-        PID(float kp, float ki, float kd) : kp(kp), ki(ki), kd(kd){};
-        PID() = default;
+        void setConfig(const PIDConfig& config);
 
         /**
          * @brief Used to calculate the velocity of a motor or motor group. 
@@ -103,10 +109,22 @@ class PID {
          * 
          * @param error the remaining distance to the target
          * @param max_speed maximum velocity allowed in velocityUnits::pct
-         * @param mech_id string identifier for motor group to log
+         * @param mech_id registry id of the motor group to log
          * @return a calculated speed based on all PID parameters
          */
-        float calculateSpeed(float error, float max_speed, std::string mech_id);
+        float calculateSpeed(float error, float max_speed, int mech_id);
+
+        /**
+         * @brief Calculates the speed like calculateSpeed(error, max_speed, mech_id), logging
+         * what the motors did this tick next to the PID terms when telemetry is enabled.
+         * 
+         * @param error the remaining distance to the target
+         * @param max_speed maximum velocity allowed in velocityUnits::pct
+         * @param mech_id registry id of the motor group to log
+         * @param telemetry the measured state of the motors this tick
+         * @return a calculated speed based on all PID parameters
+         */
+        float calculateSpeed(float error, float max_speed, int mech_id, const Telemetry& telemetry);
 
         /**
          * @brief Set the error range in rotationUnits::deg.
@@ -145,6 +163,18 @@ class PID {
          */
         void setLowSpeedThreshold(int threshold);
 
+        /**
+         * @brief Ends moves on measured motion instead of the commanded speed. A move
+         * settles once its error and measured speed have stayed inside the band for the
+         * settle time, such as within 1 degree and below 5 degrees per second for 60ms.
+         * The error range and low speed threshold are not used while this is set.
+         * 
+         * @param error the error band in rotationUnits::deg, or -1 to go back to the error range and low speed threshold
+         * @param velocity the measured speed band in degrees per second
+         * @param time how long the system must stay in the band in milliseconds
+         */
+        void setSettleCriteria(float error, float velocity, int time);
+
         /**
          * @brief Set the timeout to use for PID movement. If the timeout is exceeded, 
          * the system will stop regardless of the current error or speed.
@@ -161,35 +191,74 @@ class PID {
          */
         void setMaxIntegral(int max_integral);
 
+        /**
+         * @brief Adds the measured velocity, current, temperature and battery voltage to the log.
+         * The values come from the motor bus sample the mechanism already takes each tick.
+         * @param enabled true to log telemetry
+         */
+        void setTelemetry(bool enabled);
+
+        /**
+         * @brief Turns writing every tick to the micro SD card log on or off. On by default.
+         * @param enabled true to log ticks
+         */
+        void setLogging(bool enabled);
+
+        /**
+         * @brief Checks if telemetry is added to the log.
+         * @return true if telemetry is enabled
+         */
+        bool telemetryEnabled(void);
+
         /**
          * @brief Checks if the movement is unfinished (error still outside the final bounds).
          * @param error the current error of the system
+         * @param speed the last calculated speed in velocityUnits::pct
          * @return returns true if the error is outside the bounds, false if it is within the bounds
          */
         bool unfinished(float error, int speed);
 
         /**
-         * @brief Resets the previous error and previous integral values.
+         * @brief Checks if the movement is unfinished, using the settle criteria when they are set.
+         * Call it once per tick, since the time in the settle band is counted between calls.
+         * @param error the current error of the system
+         * @param speed the last calculated speed in velocityUnits::pct
+         * @param velocity the measured speed of the system in degrees per second
+         * @return returns true until the system has settled or timed out
+         */
+        bool unfinished(float error, float speed, float velocity);
+
+        /**
+         * @brief Checks if the current PID run has exceeded its timeout.
+         * @return true if a timeout is set and has been exceeded
+         */
+        bool timedOut(void);
+
+        /**
+         * @brief Resets the state of the run. Its ticks were already handed to the
+         * PIDLogger as they were logged. The config, including the timeout, is kept for the next run.
          */
         void reset(void);
 
         /**
-         * @brief Duplicates the PID object by copying constants and returning a new PID object.
+         * @brief Makes a new PID object with the same constants and a fresh run.
          * Used as a helper for using the same constants on multiple mechanisms.
+         * The config is shared rather than copied.
          * @return PID 
          */
         PID copy(void);
 
         /**
-         * @brief Logs the error, speed, integral and derivative values 
-         * to a text file on a micro SD card on the robot
+         * @brief Records the error, speed, integral and derivative values, which the
+         * PIDLogger writes to a csv file on a micro SD card on the robot while the run goes on
          * @param error the robot error value
          * @param speed the calculated speed
          * @param proportional result of the proportional calculation
          * @param integral result of the integral calculation
          * @param derivative result of the derivative calculation
-         * @param mech_id the mechanism name
+         * @param mech_id the registry id of the mechanism, its name is looked up when the log is written
+         * @param telemetry the measured state of the motors, written when telemetry is enabled
          */
-        void fileLogging(float error, float speed, float proportional, float integral, float derivative, std::string mech_id);
+        void fileLogging(float error, float speed, float proportional, float integral, float derivative, int mech_id, const Telemetry& telemetry = Telemetry());
 };      
 }
\ No newline at end of file
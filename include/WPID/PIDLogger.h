@@ -0,0 +1,121 @@
+#pragma once
+#include "v5_vcs.h"
+#include "stdint.h"
+#include <atomic>
+#include "./Logger.h"
+#include "./Registry.h"
+
+namespace wpid {
+/**
+ * @brief What the motors actually did during a PID tick, recorded next to the PID terms.
+ */
+struct Telemetry {
+    float velocity;     // rpm at the mechanism output
+    float acceleration; // rpm per second at the mechanism output, from the state estimator
+    float current;      // amps
+    float temperature;  // celsius
+    float battery;      // volts
+};
+
+/**
+ * @brief Streams logged PID ticks to csv files on a micro SD card.
+ * Control ticks copy each record into a preallocated ring without taking a lock or
+ * touching the heap, and a low priority task drains the ring in chunks while the runs
+ * are still going, so a run of any length is written in full. If the writer falls behind
+ * and the ring fills up, new records are dropped and counted instead of waiting.
+ * The writer is started by start(), which every Mechanism calls when it is built.
+ */
+class PIDLogger {
+    public:
+        /**
+        * A single logged PID tick
+        */
+        struct Record {
+            uint32_t time;       // milliseconds
+            uint32_t run;        // milliseconds when the run started, which names its file
+            int log_id;          // registry id of the mechanism, its name is looked up when written
+            float error;
+            float speed;
+            float proportional;
+            float integral;
+            float derivative;
+            bool has_telemetry;  // true to write the telemetry columns
+            Telemetry telemetry;
+        };
+
+    private:
+        /**
+        * The most records waiting to be written, a power of two
+        */
+        static const uint32_t CAPACITY = 1024;
+
+        /**
+        * A record and the turn it belongs to. The sequence equals the slot's position
+        * while it is free, and the position plus one once a record is in it
+        */
+        struct Slot {
+            std::atomic<uint32_t> sequence;
+            Record record;
+        };
+        Slot slots[CAPACITY];
+
+        /**
+        * The next position a control tick claims, and the next one the writer reads
+        */
+        std::atomic<uint32_t> tail{0};
+        uint32_t head = 0;
+
+        /**
+        * Records dropped because the ring was full
+        */
+        std::atomic<uint32_t> dropped{0};
+
+        /**
+        * Set once the writer has been started
+        */
+        std::atomic<bool> started{false};
+
+        /**
+        * The logger shared by every PID. The ring is built before main, the writer by start()
+        */
+        static PIDLogger logger;
+
+        PIDLogger();
+
+        /**
+         * @brief Writes records as they arrive, forever. Runs at a low priority
+         * so writing to the SD card never delays a control loop.
+         * @return int unused
+         */
+        static int writer(void);
+
+    public:
+        PIDLogger(const PIDLogger&) = delete;
+        PIDLogger& operator=(const PIDLogger&) = delete;
+
+        /**
+         * @brief Gets the logger shared by every PID.
+         * @return PIDLogger& the logger
+         */
+        static PIDLogger& instance();
+
+        /**
+         * @brief Starts the task that writes records, if it isn't running yet. Creates a task,
+         * so call it while setting up rather than from a control tick.
+         */
+        void start();
+
+        /**
+         * @brief Queues a record to be written. Never waits or allocates, so it is safe to call from a control tick.
+         * @param record the tick to log
+         * @return true if the record was queued, false if the ring was full and it was dropped
+         */
+        bool record(const Record& record);
+
+        /**
+         * @brief Gets the number of records dropped because the writer fell behind.
+         * @return uint32_t the dropped count
+         */
+        uint32_t getDropped() const;
+};
+}
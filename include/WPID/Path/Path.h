@@ -0,0 +1,131 @@
+#pragma once
+#include "v5_vcs.h"
+#include <vector>
+#include <cmath>
+#include "../Logger.h"
+
+namespace wpid {
+/**
+ * @brief A point on the field in inches.
+ * X is to the right of the robot's starting pose and Y is forward.
+ */
+struct Point {
+    float x;
+    float y;
+};
+
+/**
+ * @brief A single sample of a path. Samples are spaced evenly by arc length,
+ * so the index of a sample multiplied by the path resolution is the distance
+ * along the path to that sample.
+ */
+struct PathPoint {
+    /** @brief X position in inches */
+    float x;
+    /** @brief Y position in inches */
+    float y;
+    /** @brief Fraction of the max speed allowed at this sample, from 0 to 1 */
+    float velocity;
+};
+
+/**
+ * @brief A smooth path through a list of waypoints, stored as an arc length lookup table.
+ * The curve and its arc length parameterization are computed once when the path is built,
+ * so followers only ever index into a flat array while the robot is moving.
+ */
+class Path {
+    private:
+        /**
+        * Samples along the path, evenly spaced by arc length
+        */
+        std::vector<PathPoint> samples;
+
+        /**
+        * Distance between samples in inches
+        */
+        float resolution = 1.0;
+
+        /**
+        * Total arc length of the path in inches
+        */
+        float total_length = 0;
+
+        /**
+         * @brief Adds samples along a dense polyline so that every sample
+         * is exactly one resolution apart in arc length.
+         * @param dense the polyline to resample
+         */
+        void resample(const std::vector<Point>& dense);
+
+    public:
+        /**
+         * @brief Construct a new Path object through the given waypoints.
+         * The waypoints are joined by a Catmull-Rom spline so the robot drives
+         * a continuous curve instead of stopping at each point.
+         * @param waypoints the points the path passes through in inches, starting at the robot
+         * @param resolution the distance between lookup table samples in inches
+         */
+        Path(std::vector<Point> waypoints, float resolution = 1.0);
+
+        /**
+         * @brief Construct a new Path object from a lookup table that was already computed,
+         * such as one loaded from a compiled trajectory file.
+         * @param samples samples evenly spaced by arc length
+         * @param resolution the distance between samples in inches
+         * @param length the total arc length of the path in inches
+         */
+        Path(std::vector<PathPoint> samples, float resolution, float length);
+        Path() = default;
+
+        /**
+         * @brief Gets the number of samples in the lookup table.
+         * @return int the sample count
+         */
+        int size() const;
+
+        /**
+         * @brief Gets the total arc length of the path.
+         * @return float the length in inches
+         */
+        float length() const;
+
+        /**
+         * @brief Gets the distance between lookup table samples.
+         * @return float the resolution in inches
+         */
+        float getResolution() const;
+
+        /**
+         * @brief Gets a sample of the path by index.
+         * @param index the sample index, clamped to the ends of the path
+         * @return the path sample, or a stopped point at the origin if the path is empty
+         */
+        const PathPoint& at(int index) const;
+
+        /**
+         * @brief Gets the index of the sample at a distance along the path.
+         * Because samples are evenly spaced this is a constant time lookup.
+         * @param distance the arc length from the start of the path in inches
+         * @return int the sample index
+         */
+        int indexAt(float distance) const;
+
+        /**
+         * @brief Gets the distance along the path of a sample.
+         * @param index the sample index
+         * @return float the arc length from the start of the path in inches
+         */
+        float distanceAt(int index) const;
+
+        /**
+         * @brief Finds the closest sample to a point, searching forward from a previous result.
+         * The search only moves forward and stops after a bounded number of samples,
+         * so the cost per call does not grow with the length of the path.
+         * @param point the point to search from, usually the robot position
+         * @param start_index the closest index found on the previous call
+         * @param window the maximum number of samples to search past start_index
+         * @return int the index of the closest sample, 0 if the path is empty
+         */
+        int closestIndex(Point point, int start_index, int window) const;
+};
+}
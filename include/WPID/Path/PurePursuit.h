@@ -0,0 +1,96 @@
+#pragma once
+#include "Path.h"
+
+namespace wpid {
+/**
+ * @brief The position and heading of the robot relative to where it started.
+ */
+struct Pose {
+    /** @brief X position in inches, positive to the right */
+    float x;
+    /** @brief Y position in inches, positive forward */
+    float y;
+    /** @brief Heading in radians, positive clockwise to match Chassis::turn */
+    float heading;
+};
+
+/**
+ * @brief Tracks the robot along a Path and finds the lookahead point each tick.
+ * The follower keeps track of the closest sample between calls so each update
+ * only searches a small window ahead of the previous result.
+ */
+class PurePursuit {
+    private:
+        /**
+        * The path being followed
+        */
+        const Path* path;
+
+        /**
+        * Lookahead distance in inches
+        */
+        float lookahead;
+
+        /**
+        * Number of lookahead samples, precomputed from the path resolution
+        */
+        int lookahead_samples;
+
+        /**
+        * Index of the closest path sample to the robot
+        */
+        int closest = 0;
+
+        /**
+        * Current robot pose from wheel odometry
+        */
+        Pose pose = {0, 0, 0};
+
+    public:
+        /**
+         * @brief Construct a new PurePursuit follower.
+         * @param path the path to follow, which must outlive the follower
+         * @param lookahead the lookahead distance in inches
+         */
+        PurePursuit(const Path* path, float lookahead);
+
+        /**
+         * @brief Integrates wheel odometry into the pose and advances the closest sample.
+         * @param forward distance driven forward since the last update in inches
+         * @param lateral distance driven to the right since the last update in inches
+         * @param rotation change in heading since the last update in radians, positive clockwise
+         */
+        void update(float forward, float lateral, float rotation);
+
+        /**
+         * @brief Gets the current pose of the robot.
+         * @return the pose relative to the start of the path
+         */
+        const Pose& getPose() const;
+
+        /**
+         * @brief Gets the index of the closest path sample found by the last update.
+         * @return int the sample index
+         */
+        int getClosestIndex() const;
+
+        /**
+         * @brief Gets the lookahead point in the robot's frame.
+         * @return Point x is to the right of the robot, y is forward in inches
+         */
+        Point lookaheadLocal() const;
+
+        /**
+         * @brief Gets the curvature of the arc from the robot to the lookahead point.
+         * @return float curvature in 1/inches, positive when turning clockwise
+         */
+        float curvature() const;
+
+        /**
+         * @brief Gets the remaining distance to the end of the path.
+         * Becomes negative if the robot drives past the final point.
+         * @return float distance in inches
+         */
+        float remaining() const;
+};
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "v5_vcs.h"
+#include "stdint.h"
+#include <cstdio>
+#include <vector>
+#include <utility>
+#include "Path.h"
+
+namespace wpid {
+/**
+ * @brief The header at the start of a compiled trajectory file.
+ * The chassis geometry matches the arguments of the Tank and HDrive constructors.
+ */
+struct TrajectoryHeader {
+    /** @brief Always "WPTJ" */
+    char magic[4];
+    /** @brief File format version */
+    uint16_t version;
+    /** @brief Number of paths in the file */
+    uint16_t path_count;
+    /** @brief Chassis track width the routine was compiled for */
+    float track_width;
+    /** @brief Chassis wheel radius the routine was compiled for */
+    float wheel_radius;
+    /** @brief Center wheel radius the routine was compiled for, 0 for Tank */
+    float center_wheel_radius;
+    /** @brief Drive gear ratio the routine was compiled for */
+    float drive_gear_ratio;
+};
+
+/**
+ * @brief The header before the samples of each path in a compiled trajectory file.
+ */
+struct TrajectoryPathHeader {
+    /** @brief Number of PathPoint samples that follow */
+    uint32_t sample_count;
+    /** @brief Distance between samples in inches */
+    float resolution;
+    /** @brief Total arc length of the path in inches */
+    float length;
+};
+
+/**
+ * @brief A set of paths compiled ahead of time by python_resources/compileTrajectory.py.
+ * Loading copies each path's samples straight from the file into its lookup table,
+ * so no spline or velocity profile is computed on the brain.
+ */
+class Trajectory {
+    private:
+        /**
+        * Version of the file format this library reads
+        */
+        static constexpr uint16_t VERSION = 1;
+
+        /**
+        * The header of the loaded file
+        */
+        TrajectoryHeader header = {};
+
+        /**
+        * The loaded paths, in the order they were compiled
+        */
+        std::vector<Path> paths;
+
+    public:
+        Trajectory() = default;
+
+        /**
+         * @brief Loads a compiled trajectory file from the micro SD card.
+         * Call this in init() so the paths are ready before autonomous starts.
+         * @param filename the name of the file on the SD card
+         * @return true if every path was loaded
+         */
+        bool load(const char* filename);
+
+        /**
+         * @brief Gets the number of loaded paths.
+         * @return int the path count
+         */
+        int size() const;
+
+        /**
+         * @brief Gets a loaded path to pass to Chassis::followPath.
+         * @param index the index of the path in the routine
+         * @return the path, or an empty path with a size of 0 if there is no path at the index.
+         * followPath does nothing with an empty path
+         */
+        const Path& getPath(int index) const;
+
+        /**
+         * @brief Checks that the file was compiled for the given chassis geometry,
+         * using the same arguments as the HDrive constructor. Logs a warning for any mismatch.
+         * @param track_width the width between left and right
+         * @param wheel_radius radius of the wheel
+         * @param center_wheel_radius radius of the center wheel, 0 for Tank
+         * @param drive_gear_ratio the internal gearset of the drive train
+         * @return true if the geometry matches
+         */
+        bool checkChassis(float track_width, float wheel_radius, float center_wheel_radius, float drive_gear_ratio) const;
+};
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "v5_vcs.h"
+#include <string>
+#include <deque>
+
+namespace wpid {
+/**
+ * @brief Gives every mechanism name a small integer id, so the control loops pass
+ * an int around each tick and the name is only looked up when a log is written.
+ * Console lines from a control loop show the id as #id, and each id is logged with its
+ * name once when it is registered.
+ * Registering the same name twice returns the same id.
+ */
+class Registry {
+    private:
+        /**
+        * The registered names, indexed by id. A deque keeps references to them valid as names are added
+        */
+        static std::deque<std::string>& names();
+
+        /**
+        * Guards the names between tasks registering at the same time
+        */
+        static vex::mutex& lock();
+
+    public:
+        /**
+         * @brief Gets the id of a name, registering it if it is new.
+         * @param name the name to log the mechanism as
+         * @return int the id of the name
+         */
+        static int intern(const std::string& name);
+
+        /**
+         * @brief Gets the name registered with an id.
+         * @param id an id returned by intern()
+         * @return const std::string& the name, or "UNKNOWN" for an id that was never registered
+         */
+        static const std::string& name(int id);
+};
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "v5_vcs.h"
+#include <vector>
+#include "Routine.h"
+
+namespace wpid {
+/**
+ * @brief Runs many Routines cooperatively from a single control loop.
+ * Each tick advances every routine in the order they were added, so overlapping
+ * behaviors interleave the same way on every run.
+ */
+class Executor {
+    private:
+        /**
+        * The routines being run, in the order they were added
+        */
+        std::vector<Routine> routines;
+
+        /**
+        * Number of ticks since the executor started
+        */
+        uint32_t tick_count = 0;
+
+    public:
+        Executor() = default;
+
+        /**
+         * @brief Adds a copy of a routine to run, starting on the next tick.
+         * @param routine the routine to run
+         * @return int the index of the routine, used with cancel()
+         */
+        int add(const Routine& routine);
+
+        /**
+         * @brief Advances every routine by one tick.
+         * Call this from the control loop, or use run() to tick until every routine is done.
+         */
+        void tick();
+
+        /**
+         * @brief Ticks every routine until they are all done.
+         * @param period the time between ticks in milliseconds
+         */
+        void run(int period = 10);
+
+        /**
+         * @brief Checks if every routine has finished.
+         * @return true once all routines are done
+         */
+        bool done() const;
+
+        /**
+         * @brief Cancels one routine and the motion it is running.
+         * @param index the index returned by add()
+         */
+        void cancel(int index);
+
+        /**
+         * @brief Cancels every routine and the motions they are running.
+         */
+        void cancelAll();
+
+        /**
+         * @brief Gets the number of ticks since the executor started.
+         * @return uint32_t the tick count
+         */
+        uint32_t getTickCount() const;
+};
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "v5_vcs.h"
+#include <functional>
+#include <vector>
+#include "../Completion.h"
+#include "../Logger.h"
+
+namespace wpid {
+/**
+ * @brief A sequence of steps that runs cooperatively on an Executor.
+ * Each step either starts a motion and waits for its Completion, waits for a time or
+ * a condition, or runs a function. Steps are written in order with the builder functions:
+ *
+ *     Routine score = Routine("SCORE")
+ *         .then([]{ return chassis->straightAsync(24, 60); })
+ *         .then([]{ return whenAll(lift->moveAbsoluteAsync(90, 50), chassis->turnAsync(90, 40)); })
+ *         .wait(200)
+ *         .call([]{ intake->spin(100); });
+ *
+ * A routine does not own a task; it only advances when its executor ticks, so many
+ * routines can overlap without a thread each.
+ */
+class Routine {
+    private:
+        /**
+        * A single step of the routine
+        */
+        struct Step {
+            enum Type {MOTION, WAIT, UNTIL, CALL};
+            Type type;
+            std::function<Completion()> motion;
+            std::function<bool()> condition;
+            std::function<void()> action;
+            int duration;
+        };
+
+        /**
+        * Name used when logging
+        */
+        const char* name = "ROUTINE";
+
+        /**
+        * The steps of the routine, in order
+        */
+        std::vector<Step> steps;
+
+        /**
+        * Index of the running step, -1 before the routine starts
+        */
+        int current = -1;
+
+        /**
+        * The motion started by the running step
+        */
+        Completion running;
+
+        /**
+        * Time the running step started in milliseconds
+        */
+        uint32_t step_start = 0;
+
+        /**
+         * @brief Checks if the running step has finished.
+         * @param now the executor tick time in milliseconds
+         * @return true if the routine can move on to the next step
+         */
+        bool stepFinished(uint32_t now);
+
+        /**
+         * @brief Starts the step at the current index.
+         * @param now the executor tick time in milliseconds
+         */
+        void startStep(uint32_t now);
+
+    public:
+        /**
+         * @brief Construct a new Routine object.
+         * @param name a name for the routine to use during logging
+         */
+        Routine(const char* name) : name(name){};
+        Routine() = default;
+
+        /**
+         * @brief Adds a step that starts a motion and waits for it to finish.
+         * @param motion a function that starts the motion and returns its Completion
+         * @return Routine& this routine, to add more steps
+         */
+        Routine& then(std::function<Completion()> motion);
+
+        /**
+         * @brief Adds a step that waits for a fixed time.
+         * @param duration the time to wait in milliseconds
+         * @return Routine& this routine, to add more steps
+         */
+        Routine& wait(int duration);
+
+        /**
+         * @brief Adds a step that waits until a condition is true.
+         * The condition is checked once every executor tick.
+         * @param condition a function returning true when the routine should continue
+         * @return Routine& this routine, to add more steps
+         */
+        Routine& until(std::function<bool()> condition);
+
+        /**
+         * @brief Adds a step that runs a function and continues in the same tick.
+         * @param action the function to run
+         * @return Routine& this routine, to add more steps
+         */
+        Routine& call(std::function<void()> action);
+
+        /**
+         * @brief Advances the routine by starting every step that is ready.
+         * Called by the Executor once per tick.
+         * @param now the executor tick time in milliseconds
+         * @return true while the routine still has steps to run
+         */
+        bool tick(uint32_t now);
+
+        /**
+         * @brief Checks if every step of the routine has finished.
+         * @return true once the routine is done
+         */
+        bool done() const;
+
+        /**
+         * @brief Cancels the running motion and skips the remaining steps.
+         */
+        void cancel();
+
+        /**
+         * @brief Rewinds the routine so it can run again.
+         */
+        void reset();
+};
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "v5.h"
+#include "v5_vcs.h"
+#include <vector>
+#include "./Logger.h"
+
+namespace wpid {
+/**
+ * @brief Runs periodic control tasks in rate groups on shared worker tasks.
+ * Every task with the same period shares one worker, so ten moves at 20 ms wake
+ * once per period instead of ten times. Each group starts at its own phase offset
+ * so groups don't all wake in the same millisecond, and shorter periods run at a
+ * higher priority so a slow group can't delay a fast one:
+ *
+ *     int job = Scheduler::instance().add(10, tick, this); // tick(this) every 10 ms
+ *
+ * A task returns false when it is finished and is removed from its group.
+ */
+class Scheduler {
+    public:
+        /**
+        * A periodic task, called with the data it was added with.
+        * Returns true to keep running or false to leave its group
+        */
+        typedef bool (*Task)(void* data);
+
+    private:
+        /**
+        * A task in a group, an id of 0 marks a free slot
+        */
+        struct Job {
+            int id;
+            Task task;
+            void* data;
+        };
+
+        /**
+        * The most tasks one group runs at once
+        */
+        static const int MAX_JOBS = 16;
+
+        /**
+        * Tasks sharing a period and a worker
+        */
+        struct Group {
+            int period;          // milliseconds between ticks
+            int phase;           // milliseconds after the scheduler epoch of the first tick
+            Job jobs[MAX_JOBS];
+            uint32_t ticks;      // ticks run
+            uint32_t overruns;   // ticks skipped because the group ran past its next slot
+            vex::thread* worker;
+        };
+
+        /**
+        * The rate groups, in the order they were made. Groups are never freed
+        */
+        std::vector<Group*> groups;
+
+        /**
+        * Guards the groups between the workers and tasks adding jobs
+        */
+        vex::mutex lock;
+
+        /**
+        * The id of the last job added
+        */
+        int last_id = 0;
+
+        /**
+        * The time every group's phase is counted from in milliseconds
+        */
+        uint32_t epoch = 0;
+
+        Scheduler() = default;
+
+        /**
+         * @brief Runs a group's tasks every period, forever.
+         * @param data the group
+         * @return int unused
+         */
+        static int run(void* data);
+
+        /**
+         * @brief Gets the group for a period, making it and its worker if it is new.
+         * The lock must be held.
+         * @param period the period in milliseconds
+         * @return Group* the group
+         */
+        Group* group(int period);
+
+    public:
+        /**
+         * @brief Gets the scheduler shared by every control loop.
+         * @return Scheduler& the scheduler
+         */
+        static Scheduler& instance();
+
+        /**
+         * @brief Runs a task every period, starting on the group's next tick.
+         * @param period the time between calls in milliseconds
+         * @param task the function to call
+         * @param data passed to the task
+         * @return int the job id, or -1 if the group is full
+         */
+        int add(int period, Task task, void* data);
+
+        /**
+         * @brief Removes a task from its group. A task that is running finishes its tick first.
+         * @param job the id returned by add()
+         */
+        void remove(int job);
+
+        /**
+         * @brief Gets the number of ticks that were skipped because a group ran
+         * longer than its period, a sign the CPU is overloaded.
+         * @return uint32_t the overrun count over every group
+         */
+        uint32_t getOverruns();
+};
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "v5.h"
+#include "v5_vcs.h"
+#include <atomic>
+
+namespace wpid {
+/**
+ * @brief Publishes a small plain struct from one task to another without blocking the reader.
+ * Writers take a lock and bump a sequence number around the copy. A reader copies the
+ * struct and checks the sequence did not change while it was copying, trying again if it
+ * did, so a control loop always sees a whole set of values and never waits on a lock.
+ * Values with a single writer, such as a control loop's own state, are published without the lock:
+ *
+ *     Seqlock<Params> params;
+ *     params.update([](Params& p){p.offset = 5;}); // any task
+ *     Params current = params.read();             // control loop, once per tick
+ *     state.publish(measured);                    // control loop, the state's only writer
+ *
+ * @tparam T a struct that is safe to copy with memcpy
+ */
+template <typename T>
+class Seqlock {
+    private:
+        /**
+        * Even when the data is stable, odd while a writer is copying into it
+        */
+        std::atomic<uint32_t> sequence{0};
+
+        /**
+        * The published values
+        */
+        T data = T();
+
+        /**
+        * Keeps writers from interleaving, readers never take it
+        */
+        vex::mutex writer;
+
+    public:
+        Seqlock() = default;
+        Seqlock(const Seqlock&) = delete;
+        Seqlock& operator=(const Seqlock&) = delete;
+
+        /**
+         * @brief Gets a consistent copy of the published values.
+         * @return T the values
+         */
+        T read() const {
+            T copy;
+            uint32_t before, after;
+            do {
+                before = sequence.load(std::memory_order_acquire);
+                if(before & 1) {vex::this_thread::yield(); continue;}
+                copy = data;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = sequence.load(std::memory_order_relaxed);
+                if(before == after) {break;}
+            } while(true);
+            return copy;
+        }
+
+        /**
+         * @brief Replaces the published values.
+         * @param value the new values
+         */
+        void write(const T& value) {
+            this->update([&value](T& data){data = value;});
+        }
+
+        /**
+         * @brief Replaces the published values without taking the lock. Only for values
+         * with a single writer, such as a control loop publishing its own measurements.
+         * @param value the new values
+         */
+        void publish(const T& value) {
+            uint32_t start = sequence.load(std::memory_order_relaxed);
+            sequence.store(start + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            data = value;
+            sequence.store(start + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Changes some of the published values, so two tasks changing
+         * different fields at the same time don't overwrite each other.
+         * @param change a function that changes the values in place
+         */
+        template <typename F>
+        void update(F change) {
+            writer.lock();
+            T next = data;
+            change(next);
+            uint32_t start = sequence.load(std::memory_order_relaxed);
+            sequence.store(start + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            data = next;
+            sequence.store(start + 2, std::memory_order_release);
+            writer.unlock();
+        }
+};
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+namespace wpid {
+/**
+ * @brief A distance stored in inches, the standard length unit of this library.
+ * Lengths are built with literals such as 24_in or 0.6_m, so conversion happens at
+ * compile time and passing an angle where a distance is expected fails to compile.
+ */
+class Length {
+    private:
+        /**
+        * The distance in inches
+        */
+        float inches;
+
+    public:
+        /**
+         * @brief Construct a new Length object.
+         * @param inches the distance in inches
+         */
+        constexpr explicit Length(float inches) : inches(inches){};
+
+        /** @brief Gets the length in inches */
+        constexpr float in() const {return inches;}
+        /** @brief Gets the length in feet */
+        constexpr float ft() const {return inches / 12.0f;}
+        /** @brief Gets the length in meters */
+        constexpr float m() const {return inches / 39.3701f;}
+        /** @brief Gets the length in centimeters */
+        constexpr float cm() const {return inches / 0.393701f;}
+
+        constexpr Length operator-() const {return Length(-inches);}
+        constexpr Length operator+(Length other) const {return Length(inches + other.inches);}
+        constexpr Length operator-(Length other) const {return Length(inches - other.inches);}
+        constexpr Length operator*(float scale) const {return Length(inches * scale);}
+        constexpr Length operator/(float scale) const {return Length(inches / scale);}
+        constexpr bool operator<(Length other) const {return inches < other.inches;}
+        constexpr bool operator>(Length other) const {return inches > other.inches;}
+};
+
+/**
+ * @brief An angle stored in degrees, the standard angle unit of this library.
+ * Angles are built with literals such as 90_deg or 0.5_rev.
+ */
+class Angle {
+    private:
+        /**
+        * The angle in degrees
+        */
+        float degrees;
+
+    public:
+        /**
+         * @brief Construct a new Angle object.
+         * @param degrees the angle in degrees
+         */
+        constexpr explicit Angle(float degrees) : degrees(degrees){};
+
+        /** @brief Gets the angle in degrees */
+        constexpr float deg() const {return degrees;}
+        /** @brief Gets the angle in radians */
+        constexpr float rad() const {return degrees * 0.0174532925f;}
+        /** @brief Gets the angle in revolutions */
+        constexpr float rev() const {return degrees / 360.0f;}
+
+        constexpr Angle operator-() const {return Angle(-degrees);}
+        constexpr Angle operator+(Angle other) const {return Angle(degrees + other.degrees);}
+        constexpr Angle operator-(Angle other) const {return Angle(degrees - other.degrees);}
+        constexpr Angle operator*(float scale) const {return Angle(degrees * scale);}
+        constexpr Angle operator/(float scale) const {return Angle(degrees / scale);}
+        constexpr bool operator<(Angle other) const {return degrees < other.degrees;}
+        constexpr bool operator>(Angle other) const {return degrees > other.degrees;}
+};
+
+/**
+ * Unit literals, available with `using namespace wpid;` or `using namespace wpid::literals;`
+ */
+inline namespace literals {
+constexpr Length operator"" _in(long double value) {return Length(value);}
+constexpr Length operator"" _in(unsigned long long value) {return Length(value);}
+constexpr Length operator"" _ft(long double value) {return Length(value * 12.0);}
+constexpr Length operator"" _ft(unsigned long long value) {return Length(value * 12.0);}
+constexpr Length operator"" _yd(long double value) {return Length(value * 36.0);}
+constexpr Length operator"" _yd(unsigned long long value) {return Length(value * 36.0);}
+constexpr Length operator"" _m(long double value) {return Length(value * 39.3701);}
+constexpr Length operator"" _m(unsigned long long value) {return Length(value * 39.3701);}
+constexpr Length operator"" _cm(long double value) {return Length(value * 0.393701);}
+constexpr Length operator"" _cm(unsigned long long value) {return Length(value * 0.393701);}
+constexpr Length operator"" _mm(long double value) {return Length(value * 0.0393701);}
+constexpr Length operator"" _mm(unsigned long long value) {return Length(value * 0.0393701);}
+
+constexpr Angle operator"" _deg(long double value) {return Angle(value);}
+constexpr Angle operator"" _deg(unsigned long long value) {return Angle(value);}
+constexpr Angle operator"" _rad(long double value) {return Angle(value * 57.2957795);}
+constexpr Angle operator"" _rad(unsigned long long value) {return Angle(value * 57.2957795);}
+constexpr Angle operator"" _rev(long double value) {return Angle(value * 360.0);}
+constexpr Angle operator"" _rev(unsigned long long value) {return Angle(value * 360.0);}
+}
+}
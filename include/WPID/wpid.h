@@ -1,10 +1,17 @@
 #pragma once
 
 /**
-* Both Chassis Headers
+* Chassis Headers
 */
 #include "./Chassis/HDrive.h"
 #include "./Chassis/Tank.h"
+#include "./Chassis/Holonomic.h"
+
+/**
+* Drivetrain Kinematics Headers
+*/
+#include "./Chassis/Kinematics.h"
+#include "./Chassis/Drivetrain.h"
 
 /**
 * Mechanism Header
@@ -12,6 +19,36 @@
 #include "./Mechanism/Mechanism.h"
 
 /**
-* Logger Header
+* Motor IO Headers
+*/
+#include "./IO/MotorBus.h"
+#include "./IO/StateEstimator.h"
+
+/**
+* Completion Header
+*/
+#include "./Completion.h"
+
+/**
+* Unit Header
+*/
+#include "./Units.h"
+
+/**
+* Logger Headers
+*/
+#include "./Logger.h"
+#include "./PIDLogger.h"
+
+/**
+* Path Headers
+*/
+#include "./Path/Path.h"
+#include "./Path/PurePursuit.h"
+#include "./Path/Trajectory.h"
+
+/**
+* Routine Headers
 */
-#include "./Logger.h"
\ No newline at end of file
+#include "./Routine/Routine.h"
+#include "./Routine/Executor.h"
\ No newline at end of file
@@ -12,5 +12,6 @@ extern controller* con;
 
 extern HDrive* chassis;
 extern Mechanism* fourbar;
+extern Trajectory routine;
 
 void init(void);
\ No newline at end of file
@@ -0,0 +1,134 @@
+import json
+import math
+import struct
+import sys
+
+# Compiles a routine description into a binary trajectory file that
+# wpid::Trajectory::load() reads from the SD card.
+#
+# usage: python compileTrajectory.py routine.json auton.traj
+#
+# The routine description is JSON:
+# {
+#   "chassis": {"track_width": 12.5, "wheel_radius": 1.625,
+#               "center_wheel_radius": 1.625, "drive_gear_ratio": 1, "motor_rpm": 200},
+#   "resolution": 1.0,
+#   "paths": [
+#     {"name": "score", "waypoints": [[0, 0], [0, 24], [24, 48]],
+#      "max_velocity": 40, "max_acceleration": 60, "min_velocity": 8}
+#   ]
+# }
+# Distances are in inches, velocities in inches per second and accelerations in
+# inches per second squared. Leave out center_wheel_radius (or set it to 0) for a Tank.
+
+MAGIC = b'WPTJ'
+VERSION = 1
+SPLINE_STEPS = 16  # must match Path::Path in Path.cpp
+
+
+def catmullRom(waypoints):
+    dense = []
+    for i in range(len(waypoints) - 1):
+        p0 = waypoints[max(i - 1, 0)]
+        p1 = waypoints[i]
+        p2 = waypoints[i + 1]
+        p3 = waypoints[min(i + 2, len(waypoints) - 1)]
+        for j in range(SPLINE_STEPS):
+            t = j / SPLINE_STEPS
+            t2 = t * t
+            t3 = t2 * t
+            dense.append(tuple(
+                0.5 * (2*p1[k] + (-p0[k] + p2[k])*t + (2*p0[k] - 5*p1[k] + 4*p2[k] - p3[k])*t2
+                       + (-p0[k] + 3*p1[k] - 3*p2[k] + p3[k])*t3)
+                for k in range(2)))
+    dense.append(tuple(waypoints[-1]))
+    return dense
+
+
+def resample(dense, resolution):
+    samples = [dense[0]]
+    length = 0.0
+    nextSample = resolution
+    for i in range(1, len(dense)):
+        dx = dense[i][0] - dense[i-1][0]
+        dy = dense[i][1] - dense[i-1][1]
+        segment = math.hypot(dx, dy)
+        while segment > 0 and length + segment >= nextSample:
+            t = (nextSample - length) / segment
+            samples.append((dense[i-1][0] + dx*t, dense[i-1][1] + dy*t))
+            nextSample += resolution
+        length += segment
+    if samples[-1] != dense[-1]:
+        samples.append(dense[-1])
+    return samples, length
+
+
+def curvature(a, b, c):
+    # curvature of the circle through three points
+    ab = math.dist(a, b)
+    bc = math.dist(b, c)
+    ca = math.dist(c, a)
+    if ab * bc * ca == 0:
+        return 0.0
+    cross = (b[0] - a[0])*(c[1] - a[1]) - (b[1] - a[1])*(c[0] - a[0])
+    return 2 * abs(cross) / (ab * bc * ca)
+
+
+def profile(samples, resolution, trackWidth, maxVelocity, maxAcceleration, minVelocity):
+    # limit speed on curves so the outside wheel never exceeds max velocity
+    velocity = [maxVelocity] * len(samples)
+    for i in range(1, len(samples) - 1):
+        k = curvature(samples[i-1], samples[i], samples[i+1])
+        velocity[i] = maxVelocity / (1 + k * trackWidth / 2)
+
+    # acceleration limits forwards from the start and backwards from the end
+    velocity[0] = minVelocity
+    for i in range(1, len(samples)):
+        velocity[i] = min(velocity[i], math.sqrt(velocity[i-1]**2 + 2*maxAcceleration*resolution))
+    velocity[-1] = min(velocity[-1], minVelocity)
+    for i in range(len(samples) - 2, -1, -1):
+        velocity[i] = min(velocity[i], math.sqrt(velocity[i+1]**2 + 2*maxAcceleration*resolution))
+
+    # stored as a fraction of the path's max velocity
+    return [max(v, minVelocity) / maxVelocity for v in velocity]
+
+
+def compileRoutine(routine):
+    chassis = routine["chassis"]
+    trackWidth = chassis["track_width"]
+    wheelRadius = chassis["wheel_radius"]
+    centerWheelRadius = chassis.get("center_wheel_radius", 0.0)
+    gearRatio = chassis.get("drive_gear_ratio", 1.0)
+    resolution = routine.get("resolution", 1.0)
+
+    # top speed of the drive, used as the default velocity limit
+    freeSpeed = chassis.get("motor_rpm", 200) / 60 * gearRatio * 2 * math.pi * wheelRadius
+
+    data = struct.pack('<4sHHffff', MAGIC, VERSION, len(routine["paths"]),
+                       trackWidth, wheelRadius, centerWheelRadius, gearRatio)
+    for path in routine["paths"]:
+        waypoints = path["waypoints"]
+        if len(waypoints) < 2:
+            sys.exit("path " + path.get("name", "") + " needs at least two waypoints")
+        maxVelocity = min(path.get("max_velocity", freeSpeed), freeSpeed)
+        maxAcceleration = path.get("max_acceleration", maxVelocity)
+        minVelocity = path.get("min_velocity", 0.2 * maxVelocity)
+
+        samples, length = resample(catmullRom(waypoints), resolution)
+        velocity = profile(samples, resolution, trackWidth, maxVelocity, maxAcceleration, minVelocity)
+
+        data += struct.pack('<Iff', len(samples), resolution, length)
+        for (x, y), v in zip(samples, velocity):
+            data += struct.pack('<fff', x, y, v)
+        print("%s: %d samples, %.1f inches" % (path.get("name", "path"), len(samples), length))
+    return data
+
+
+if len(sys.argv) != 3:
+    sys.exit("usage: python compileTrajectory.py routine.json output.traj")
+
+with open(sys.argv[1]) as file:
+    routine = json.load(file)
+
+with open(sys.argv[2], "wb") as file:
+    file.write(compileRoutine(routine))
@@ -0,0 +1,166 @@
+import math
+import random
+import sys
+
+# Measures how far behind the real motion each velocity estimate runs, on a
+# simulated motor read by a noisy encoder at the motor bus rate.
+#
+# usage: python estimatorBenchmark.py [period_ms] [noise_deg] [plot]
+#
+# The filters are copied from the robot code so the numbers match what it does:
+#   difference    - encoder delta over time with no filtering
+#   pid low pass  - the same difference through PID::calculateSpeed's 0.7 low pass
+#   fading x      - StateEstimator::fadingMemory(x)
+#   kalman q      - StateEstimator::fromNoise(q, noise, period)
+# Lag is the delay that best lines the estimate up with the true velocity. The
+# velocity error includes that lag, and the next column shifts it out first.
+
+PERIOD = float(sys.argv[1]) if len(sys.argv) > 1 else 5.0  # ms, MotorBus period
+NOISE = float(sys.argv[2]) if len(sys.argv) > 2 else 0.1    # degrees, encoder noise
+PLOT = 'plot' in sys.argv
+JITTER = 0.3        # ms, spread of the sample times around the period
+RESOLUTION = 0.05   # degrees, encoder quantization at the motor
+DURATION = 3.0      # seconds
+MAX_LAG = 100       # ms, longest lag searched for
+
+
+def trueMotion(t):
+    # accelerate to 1200 deg/s (200 rpm), hold, take a hit that drops the
+    # speed like a flywheel shot, recover, then brake to a stop
+    if t < 0.3:
+        return 4000.0
+    if 1.2 <= t < 1.25:
+        return -8000.0
+    if 1.25 <= t < 1.45:
+        return 2000.0
+    if 2.2 <= t < 2.5:
+        return -4000.0
+    return 0.0
+
+
+def simulate():
+    # integrate the true motion at 10 kHz, sampling it at the bus period
+    random.seed(1)
+    dt = 1e-4
+    position = 0.0
+    velocity = 0.0
+    truth = []
+    samples = []
+    next_sample = 0.0
+    t = 0.0
+    while t < DURATION:
+        acceleration = trueMotion(t)
+        truth.append((t, position, velocity, acceleration))
+        if t >= next_sample:
+            reading = round((position + random.gauss(0, NOISE)) / RESOLUTION) * RESOLUTION
+            samples.append((t, reading))
+            next_sample += (PERIOD + random.uniform(-JITTER, JITTER)) / 1000.0
+        velocity += acceleration * dt
+        position += velocity * dt
+        t += dt
+    return truth, samples
+
+
+def fadingMemory(theta):
+    keep = 1 - theta
+    return (1 - theta**3, 1.5 * keep * keep * (1 + theta), 0.5 * keep**3)
+
+
+def fromNoise(process_noise, measurement_noise, period):
+    # same iteration as StateEstimator::fromNoise
+    t = period / 1000.0
+    q = process_noise**2
+    r = measurement_noise**2
+    f = [[1, t, t*t/2], [0, 1, t], [0, 0, 1]]
+    noise = [[q*t**5/20, q*t**4/8, q*t**3/6],
+             [q*t**4/8, q*t**3/3, q*t**2/2],
+             [q*t**3/6, q*t**2/2, q*t]]
+    p = [[r, 0, 0], [0, r/(t*t), 0], [0, 0, r/t**4]]
+    k = [1, 0, 0]
+    for iteration in range(1000):
+        fp = [[sum(f[i][c] * p[c][j] for c in range(3)) for j in range(3)] for i in range(3)]
+        p = [[noise[i][j] + sum(fp[i][c] * f[j][c] for c in range(3)) for j in range(3)] for i in range(3)]
+        previous = k[0]
+        s = p[0][0] + r
+        k = [p[i][0] / s for i in range(3)]
+        row = list(p[0])
+        p = [[p[i][j] - k[i] * row[j] for j in range(3)] for i in range(3)]
+        if iteration > 10 and abs(k[0] - previous) < 1e-9:
+            break
+    return (k[0], k[1] * t, k[2] * t * t / 2)
+
+
+def alphaBetaGamma(samples, gains):
+    alpha, beta, gamma = gains
+    t0, position = samples[0]
+    velocity = 0.0
+    acceleration = 0.0
+    out = [(t0, 0.0, 0.0)]
+    for t, reading in samples[1:]:
+        dt = t - t0
+        t0 = t
+        predicted = position + velocity*dt + 0.5*acceleration*dt*dt
+        predicted_velocity = velocity + acceleration*dt
+        residual = reading - predicted
+        position = predicted + alpha * residual
+        velocity = predicted_velocity + beta / dt * residual
+        acceleration = acceleration + 2 * gamma / (dt*dt) * residual
+        out.append((t, velocity, acceleration))
+    return out
+
+
+def difference(samples, a):
+    out = [(samples[0][0], 0.0, None)]
+    estimate = 0.0
+    for (t0, p0), (t, p) in zip(samples, samples[1:]):
+        estimate = a * estimate + (1 - a) * (p - p0) / (t - t0)
+        out.append((t, estimate, None))
+    return out
+
+
+def truthAt(truth, t, column):
+    index = min(int(round(t / 1e-4)), len(truth) - 1)
+    return truth[max(index, 0)][column]
+
+
+def score(truth, estimate):
+    def rms(column, lag):
+        total = 0.0
+        for t, velocity, acceleration in estimate:
+            value = velocity if column == 2 else acceleration
+            total += (value - truthAt(truth, t - lag, column))**2
+        return math.sqrt(total / len(estimate))
+
+    best = min(range(MAX_LAG + 1), key = lambda lag: rms(2, lag / 1000.0))
+    velocity_error = rms(2, 0) / 6.0
+    aligned_error = rms(2, best / 1000.0) / 6.0
+    acceleration_error = rms(3, 0) / 6.0 if estimate[-1][2] is not None else None
+    return best, velocity_error, aligned_error, acceleration_error
+
+
+truth, samples = simulate()
+filters = [
+    ("difference", difference(samples, 0.0)),
+    ("pid low pass 0.7", difference(samples, 0.7)),
+]
+for theta in [0.5, 0.7, 0.85]:
+    filters.append(("fading " + str(theta), alphaBetaGamma(samples, fadingMemory(theta))))
+for process_noise in [500, 2000, 10000]:
+    filters.append(("kalman " + str(process_noise), alphaBetaGamma(samples, fromNoise(process_noise, NOISE, PERIOD))))
+
+print("%d samples every %.1f ms, encoder noise %.2f deg" % (len(samples), PERIOD, NOISE))
+print("%-18s %8s %16s %16s %18s" % ("filter", "lag ms", "velocity rpm", "without lag rpm", "accel rpm/s"))
+for name, estimate in filters:
+    lag, velocity_error, aligned_error, acceleration_error = score(truth, estimate)
+    acceleration = "%18.1f" % acceleration_error if acceleration_error is not None else "%18s" % "-"
+    print("%-18s %8d %16.2f %16.2f %s" % (name, lag, velocity_error, aligned_error, acceleration))
+
+if PLOT:
+    import matplotlib.pyplot as plt
+    plt.plot([row[0] for row in truth], [row[2] / 6.0 for row in truth], color = 'black', label = "true")
+    for name, estimate in filters:
+        plt.plot([row[0] for row in estimate], [row[1] / 6.0 for row in estimate], label = name)
+    plt.xlabel('Time')
+    plt.ylabel('Velocity (rpm)')
+    plt.legend()
+    plt.show()
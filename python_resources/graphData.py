@@ -6,7 +6,8 @@ import sys
 
 def graphMotorGroup(dataframe, motorName, arguments):
 
-    figure, axis = plt.subplots(4, 1)
+    telemetry = "Velocity" in dataframe.columns and dataframe["Velocity"].notna().any()
+    figure, axis = plt.subplots(5 if telemetry else 4, 1)
 
     axis[0].plot(dataframe["Time"], dataframe["Error"])
     axis[0].axhline(y=0.0, color='gray', linestyle='--')
@@ -54,6 +55,21 @@ def graphMotorGroup(dataframe, motorName, arguments):
     axis[3].set_ylabel('Distance to Target')
     axis[3].set_title('Distance to Target for '+motorName)
 
+    if telemetry:
+        telemetryPlots = []
+        telemetryNames = []
+        for column, color in [("Velocity", 'tab:purple'), ("Acceleration", 'tab:pink'), ("Current", 'tab:orange'), ("Temperature", 'tab:brown'), ("Battery", 'tab:olive')]:
+            if column not in dataframe.columns:
+                continue
+            line, = axis[4].plot(dataframe["Time"], dataframe[column], color = color)
+            telemetryPlots.append(line)
+            telemetryNames.append(column)
+
+        axis[4].set_xlabel('Time')
+        axis[4].set_ylabel('Measured')
+        axis[4].set_title('Motor Telemetry for '+motorName)
+        axis[4].legend(telemetryPlots, telemetryNames)
+
     figure.tight_layout()
     manager = plt.get_current_fig_manager()
     manager.window.state('zoomed')
@@ -78,9 +94,11 @@ dFs = []
 for file in allFiles:
     data = pd.read_csv("VexLogs/"+file)
     name = data["Name"].iloc[0]
-    time = data["Time"].tail(1)
-    #print(time+1)
-    data.loc[len(data.index)] = [time+1, np.NaN, np.NaN, np.NaN, np.NaN, np.NaN, name]
+    # a blank row after each run so runs are not joined in the graphs
+    row = {column: np.nan for column in data.columns}
+    row["Time"] = data["Time"].iloc[-1] + 1
+    row["Name"] = name
+    data.loc[len(data.index)] = row
     #print(name)
     dFs.append(data)
 
@@ -16,11 +16,17 @@ HDrive::HDrive(float track_width, float wheel_radius, float center_wheel_radius,
     
     this->track_width = track_width;
     this->wheel_circumference = 2.0 * M_PI * wheel_radius;
+    this->base_track_width = this->track_width;
+    this->base_wheel_circumference = this->wheel_circumference;
     this->center_wheel_circumference = 2.0 * M_PI * center_wheel_radius;
+    this->base_center_wheel_circumference = this->center_wheel_circumference;
 
     this->left = new Mechanism(left, drive_gear_ratio, "LEFT");
     this->right = new Mechanism(right, drive_gear_ratio, "RIGHT");
     this->center = new Mechanism(center, drive_gear_ratio, "CENTER");
+    this->drive = Drivetrain<HKinematics>(
+        HKinematics(this->track_width, this->wheel_circumference, this->center_wheel_circumference),
+        {this->left, this->right, this->center});
 }
 
 
@@ -52,17 +58,30 @@ void HDrive::straight(float distance, int max_speed){
     this->waitUntilSettled();
 }
 
-void HDrive::straightAsync(float distance, int max_speed){
+Completion HDrive::straightAsync(float distance, int max_speed){
     distance = Conversion::standardize(distance, this->measure_units);
+    return this->straightMotion(distance, max_speed, -1);
+}
+
+Completion HDrive::straightAsync(float distance, int max_speed, const MoveOptions& options){
+    float inches = Conversion::standardize(1, this->measure_units);
+    // trigger distances are in the same units as the distance
+    return this->straightMotion(distance * inches, max_speed, -1, options.scaled(inches));
+}
+
+void HDrive::straightChained(float distance, int max_speed){
+    this->straightChained(Length(Conversion::standardize(distance, this->measure_units)), max_speed);
+}
+
+Completion HDrive::straightMotion(float distance, int max_speed, float exit_error, const MoveOptions& options){
     if(distance > 0){
         distance += straight_offset;
     } else {
         distance -= straight_offset;
     }
-    float target = ((distance) / wheel_circumference) * 360.0;
     left->setPID(pidStraight.copy());
     right->setPID(pidStraight.copy());
-    this->spinToTarget(target, target, 0, max_speed, max_speed, 0);
+    return drive.moveBy({distance, 0, 0}, max_speed, exit_error, options, std::fabs(distance));
 }
 
 void HDrive::turn(int target_angle, int max_speed){
@@ -70,16 +89,29 @@ void HDrive::turn(int target_angle, int max_speed){
     this->waitUntilSettled();
 }
 
-void HDrive::turnAsync(float target_angle, int max_speed){
+Completion HDrive::turnAsync(float target_angle, int max_speed){
+    return this->turnMotion(target_angle, max_speed, -1);
+}
+
+Completion HDrive::turnAsync(float target_angle, int max_speed, const MoveOptions& options){
+    return this->turnMotion(target_angle, max_speed, -1, options);
+}
+
+void HDrive::turnChained(float target_angle, int max_speed){
+    float tolerance = ((track_width/2)*(turn_chain_tolerance*M_PI/180)/wheel_circumference)*360;
+    this->turnMotion(target_angle, max_speed, tolerance);
+    this->waitUntilSettled();
+}
+
+Completion HDrive::turnMotion(float target_angle, int max_speed, float exit_error, const MoveOptions& options){
     if(target_angle > 0){
         target_angle += turn_offset;
     } else {
         target_angle -= turn_offset;
     }
-    float target = ((track_width/2)*((float)(target_angle)*M_PI/180)/wheel_circumference)*360;
     left->setPID(pidTurn.copy());
     right->setPID(pidTurn.copy());
-    this->spinToTarget(target, -target, 0, max_speed, max_speed, 0);
+    return drive.moveBy({0, 0, (float)(target_angle*M_PI/180)}, max_speed, exit_error, options, std::fabs(target_angle));
 }
 
 void HDrive::strafe(float distance, int max_speed){
@@ -87,15 +119,27 @@ void HDrive::strafe(float distance, int max_speed){
     this->waitUntilSettled();
 }
 
-void HDrive::strafeAsync(float distance, int max_speed){
+Completion HDrive::strafeAsync(float distance, int max_speed){
     distance = Conversion::standardize(distance, this->measure_units);
+    return this->strafeMotion(distance, max_speed, -1);
+}
+
+Completion HDrive::strafeAsync(float distance, int max_speed, const MoveOptions& options){
+    float inches = Conversion::standardize(1, this->measure_units);
+    return this->strafeMotion(distance * inches, max_speed, -1, options.scaled(inches));
+}
+
+void HDrive::strafeChained(float distance, int max_speed){
+    this->strafeChained(Length(Conversion::standardize(distance, this->measure_units)), max_speed);
+}
+
+Completion HDrive::strafeMotion(float distance, int max_speed, float exit_error, const MoveOptions& options){
      if(distance > 0){
         distance += strafe_offset;
     } else {
         distance -= strafe_offset;
     }
-    float target = ((distance) / center_wheel_circumference) * 360.0;
-    this->spinToTarget(0, 0, target, 0, 0, max_speed);
+    return drive.moveBy({0, distance, 0}, max_speed, exit_error, options, std::fabs(distance));
 }
 
 void HDrive::diagonal(float straight_distance, float strafe_distance, int straight_max_speed){
@@ -103,23 +147,144 @@ void HDrive::diagonal(float straight_distance, float strafe_distance, int straig
     this->waitUntilSettled();
 }
 
-void HDrive::diagonalAsync(float straight_distance, float strafe_distance, int straight_max_speed){
+Completion HDrive::diagonalAsync(float straight_distance, float strafe_distance, int straight_max_speed){
     straight_distance = Conversion::standardize(straight_distance, this->measure_units);
     strafe_distance = Conversion::standardize(strafe_distance, this->measure_units);
-    float straight_target = ((straight_distance + straight_offset) / wheel_circumference) * 360.0;
-    float strafe_target = ((strafe_distance + strafe_offset) / center_wheel_circumference) * 360.0;
-    float center_max_speed = straight_max_speed*(strafe_distance / straight_distance);
-    left->setPID(pidStraight);
-    right->setPID(pidStraight);
-    this->spinToTarget(straight_target, straight_target, strafe_target, straight_max_speed, straight_max_speed, center_max_speed);
+    return this->diagonalMotion(straight_distance, strafe_distance, straight_max_speed, -1, -1);
+}
+
+void HDrive::diagonalChained(float straight_distance, float strafe_distance, int straight_max_speed){
+    this->diagonalChained(Length(Conversion::standardize(straight_distance, this->measure_units)),
+                          Length(Conversion::standardize(strafe_distance, this->measure_units)), straight_max_speed);
+}
+
+Completion HDrive::diagonalMotion(float straight_distance, float strafe_distance, int straight_max_speed, float exit_error, float center_exit_error){
+    // scale the wheel speeds together so both axes arrive at the same time
+    Drivetrain<HKinematics>::Wheels exit = {{exit_error, exit_error, center_exit_error}};
+    left->setPID(pidStraight.copy());
+    right->setPID(pidStraight.copy());
+    return drive.moveBy({straight_distance + straight_offset, strafe_distance + strafe_offset, 0}, straight_max_speed, exit);
+}
+
+void HDrive::straight(Length distance, int max_speed){
+    this->straightAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion HDrive::straightAsync(Length distance, int max_speed){
+    return this->straightMotion(distance.in(), max_speed, -1);
+}
+
+Completion HDrive::straightAsync(Length distance, int max_speed, const MoveOptions& options){
+    // trigger distances are in inches, like the distance
+    return this->straightMotion(distance.in(), max_speed, -1, options);
+}
+
+void HDrive::straightChained(Length distance, int max_speed){
+    float tolerance = (straight_chain_tolerance / wheel_circumference) * 360.0;
+    this->straightMotion(distance.in(), max_speed, tolerance);
+    this->waitUntilSettled();
+}
+
+void HDrive::turn(Angle target_angle, int max_speed){
+    this->turnAsync(target_angle, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion HDrive::turnAsync(Angle target_angle, int max_speed){
+    return this->turnMotion(target_angle.deg(), max_speed, -1);
 }
 
-void HDrive::spinToTarget(float left_target, float right_target, float center_target, int l_max_spd, int r_max_spd, int c_max_spd){
-    left->moveRelativeAsync(left_target, l_max_spd);
-    right->moveRelativeAsync(right_target, r_max_spd);
-    center->moveRelativeAsync(center_target, c_max_spd);
+Completion HDrive::turnAsync(Angle target_angle, int max_speed, const MoveOptions& options){
+    return this->turnMotion(target_angle.deg(), max_speed, -1, options);
 }
 
+void HDrive::turnChained(Angle target_angle, int max_speed){
+    this->turnChained(target_angle.deg(), max_speed);
+}
+
+void HDrive::strafe(Length distance, int max_speed){
+    this->strafeAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion HDrive::strafeAsync(Length distance, int max_speed){
+    return this->strafeMotion(distance.in(), max_speed, -1);
+}
+
+Completion HDrive::strafeAsync(Length distance, int max_speed, const MoveOptions& options){
+    return this->strafeMotion(distance.in(), max_speed, -1, options);
+}
+
+void HDrive::strafeChained(Length distance, int max_speed){
+    float tolerance = (strafe_chain_tolerance / center_wheel_circumference) * 360.0;
+    this->strafeMotion(distance.in(), max_speed, tolerance);
+    this->waitUntilSettled();
+}
+
+void HDrive::diagonal(Length straight_distance, Length strafe_distance, int straight_max_speed){
+    this->diagonalAsync(straight_distance, strafe_distance, straight_max_speed);
+    this->waitUntilSettled();
+}
+
+Completion HDrive::diagonalAsync(Length straight_distance, Length strafe_distance, int straight_max_speed){
+    return this->diagonalMotion(straight_distance.in(), strafe_distance.in(), straight_max_speed, -1, -1);
+}
+
+void HDrive::diagonalChained(Length straight_distance, Length strafe_distance, int straight_max_speed){
+    float tolerance = (straight_chain_tolerance / wheel_circumference) * 360.0;
+    float center_tolerance = (strafe_chain_tolerance / center_wheel_circumference) * 360.0;
+    this->diagonalMotion(straight_distance.in(), strafe_distance.in(), straight_max_speed, tolerance, center_tolerance);
+    this->waitUntilSettled();
+}
+
+void HDrive::followPath(const Path& path, int max_speed, float lookahead){
+    static const int path_id = Registry::intern("PATH");
+    static const int path_turn_id = Registry::intern("PATH_TURN");
+    if(path.size() == 0){
+        LOG(WARN) << "Cannot follow an empty path";
+        return;
+    }
+    PurePursuit follower = PurePursuit(&path, lookahead);
+    PID pid = pidStraight.copy();
+    PID heading_pid = pidTurn.copy();
+    float error = 999;
+    int speed = 999;
+    drive.resetOdometry();
+
+    LOG(DEBUG) << "following path of length " << path.length() << " with max speed " << max_speed;
+
+    while(pid.unfinished(error, speed)){
+        // wheel odometry since the last tick, in inches
+        BodyMotion moved = drive.odometry();
+        follower.update(moved.forward, moved.lateral, moved.rotation);
+
+        // slow down over the remaining length, limited by the path's velocity at this point
+        error = (follower.remaining() / wheel_circumference) * 360.0;
+        float limit = max_speed * path.at(follower.getClosestIndex()).velocity;
+        speed = pid.calculateSpeed(error, limit, path_id);
+
+        // translate towards the lookahead point
+        Point target = follower.lookaheadLocal();
+        float distance = std::sqrt(target.x*target.x + target.y*target.y);
+        float forward_speed = distance > 0 ? speed * target.y / distance : 0;
+        float lateral_speed = distance > 0 ? speed * target.x / distance : 0;
+
+        // hold the starting heading, in the same wheel degrees as turnAsync targets
+        float heading_error = ((track_width/2) * -follower.getPose().heading / wheel_circumference) * 360;
+        float turn_speed = heading_pid.calculateSpeed(heading_error, max_speed, path_turn_id);
+
+        drive.spin({forward_speed, lateral_speed, turn_speed / (track_width/2)}, max_speed);
+        this_thread::sleep_for(pid.getDelayTime());
+    }
+
+    LOG(DEBUG) << "Finished path with " << follower.remaining() << " inches remaining";
+    this->stop();
+    pid.reset();
+    heading_pid.reset();
+}
+
+
 void HDrive::stop(){
     left->stop();
     right->stop();
@@ -162,6 +327,14 @@ void HDrive::setOffset(float straight, float turn, float center){
     strafe_offset = center;
 }
 
+void HDrive::setChainTolerance(float straight, float turn, float strafe){
+    if(straight < 0 || turn < 0 || strafe < 0)
+        LOG(WARN) << "Negative chain tolerances not allowed";
+    straight_chain_tolerance = straight;
+    turn_chain_tolerance = turn;
+    strafe_chain_tolerance = strafe;
+}
+
 void HDrive::setMaxAcceleration(float straight_max_accel, float c_max_accel){
     if(straight_max_accel < 0 || c_max_accel < 0)
         LOG(WARN) << "Negative accelerations not allowed";
@@ -170,6 +343,24 @@ void HDrive::setMaxAcceleration(float straight_max_accel, float c_max_accel){
     this->center->setMaxAcceleration(c_max_accel);
 }
 
+void HDrive::setVoltageCompensation(float nominal){
+    this->left->setVoltageCompensation(nominal);
+    this->right->setVoltageCompensation(nominal);
+    this->center->setVoltageCompensation(nominal);
+}
+
+void HDrive::setThermalLimit(float start, float limit, float min_scale, float max_current){
+    this->left->setThermalLimit(start, limit, min_scale, max_current);
+    this->right->setThermalLimit(start, limit, min_scale, max_current);
+    this->center->setThermalLimit(start, limit, min_scale, max_current);
+}
+
+void HDrive::setCascade(PID velocity_pid, float max_velocity){
+    this->left->setCascade(velocity_pid, max_velocity);
+    this->right->setCascade(velocity_pid, max_velocity);
+    this->center->setCascade(velocity_pid, max_velocity);
+}
+
 void HDrive::setTimeout(int timeout){
     this->pidStraight.setTimeout(timeout);
     this->pidTurn.setTimeout(timeout);
@@ -178,6 +369,8 @@ void HDrive::setTimeout(int timeout){
 
 void HDrive::setMeasurementUnits(Conversion::measurement preferred_units){
     this->measure_units = preferred_units;
-    this->wheel_circumference = Conversion::standardize(this->wheel_circumference, preferred_units);
-    this->track_width = Conversion::standardize(this->track_width, preferred_units);
+    this->wheel_circumference = Conversion::standardize(this->base_wheel_circumference, preferred_units);
+    this->track_width = Conversion::standardize(this->base_track_width, preferred_units);
+    this->center_wheel_circumference = Conversion::standardize(this->base_center_wheel_circumference, preferred_units);
+    this->drive.setKinematics(HKinematics(this->track_width, this->wheel_circumference, this->center_wheel_circumference));
 }
@@ -0,0 +1,397 @@
+#include "WPID/Chassis/Holonomic.h"
+
+using namespace vex;
+using namespace wpid;
+
+Holonomic::Holonomic(HolonomicKinematics kinematics, vex::motor_group* front_left, vex::motor_group* front_right,
+                     vex::motor_group* back_left, vex::motor_group* back_right, float drive_gear_ratio){
+    if(drive_gear_ratio <= 0)
+        LOG(WARN) << "Cannot use a non-positive drive ratio";
+    if(front_left->count() == 0)
+        LOG(WARN) << "No motors found in \"FRONT_LEFT\" motor group";
+    if(front_right->count() == 0)
+        LOG(WARN) << "No motors found in \"FRONT_RIGHT\" motor group";
+    if(back_left->count() == 0)
+        LOG(WARN) << "No motors found in \"BACK_LEFT\" motor group";
+    if(back_right->count() == 0)
+        LOG(WARN) << "No motors found in \"BACK_RIGHT\" motor group";
+
+    this->base_kinematics = kinematics;
+    this->track_width = 2 * kinematics.turnRadius();
+    this->wheel_circumference = kinematics.circumference(0);
+    this->base_track_width = this->track_width;
+    this->base_wheel_circumference = this->wheel_circumference;
+
+    this->left = new Mechanism(front_left, drive_gear_ratio, "FRONT_LEFT");
+    this->right = new Mechanism(front_right, drive_gear_ratio, "FRONT_RIGHT");
+    this->back_left = new Mechanism(back_left, drive_gear_ratio, "BACK_LEFT");
+    this->back_right = new Mechanism(back_right, drive_gear_ratio, "BACK_RIGHT");
+    this->drive = Drivetrain<HolonomicKinematics>(kinematics, {this->left, this->right, this->back_left, this->back_right});
+}
+
+HolonomicKinematics Holonomic::xDrive(float track_width, float wheel_radius){
+    // each wheel rolls at 45 degrees, sqrt(2)/2 of its travel goes forward and sideways
+    float s = M_SQRT1_2;
+    float r = track_width * M_SQRT1_2;
+    float matrix[4][3] = {
+        {s,  s,  r},
+        {s, -s, -r},
+        {s, -s,  r},
+        {s,  s, -r}
+    };
+    return HolonomicKinematics(matrix, 2.0 * M_PI * wheel_radius);
+}
+
+HolonomicKinematics Holonomic::mecanum(float track_width, float wheel_base, float wheel_radius){
+    float r = (track_width + wheel_base) / 2;
+    float matrix[4][3] = {
+        {1,  1,  r},
+        {1, -1, -r},
+        {1, -1,  r},
+        {1,  1, -r}
+    };
+    return HolonomicKinematics(matrix, 2.0 * M_PI * wheel_radius);
+}
+
+void Holonomic::setStraightPID(PID pid){
+    pidStraight = pid;
+}
+
+void Holonomic::setTurnPID(PID pid){
+    pidTurn = pid;
+}
+
+void Holonomic::setStrafePID(PID pid){
+    pidStrafe = pid;
+}
+
+void Holonomic::spin(int forward, int lateral, int turn){
+    // a full turn command spins the wheels as fast as a full forward command
+    float radius = drive.getKinematics().turnRadius();
+    float rotation = radius > 0 ? turn / radius : 0;
+    drive.spin({(float)forward, (float)lateral, rotation}, 100);
+}
+
+void Holonomic::straight(float distance, int max_speed){
+    this->straightAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::straightAsync(float distance, int max_speed){
+    return this->straightInches(Conversion::standardize(distance, this->measure_units), max_speed, false);
+}
+
+Completion Holonomic::straightAsync(float distance, int max_speed, const MoveOptions& options){
+    float inches = Conversion::standardize(1, this->measure_units);
+    // trigger distances are in the same units as the distance
+    return this->straightInches(distance * inches, max_speed, false, options.scaled(inches));
+}
+
+void Holonomic::straightChained(float distance, int max_speed){
+    this->straightInches(Conversion::standardize(distance, this->measure_units), max_speed, true);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::straightInches(float distance, int max_speed, bool chained, const MoveOptions& options){
+    distance += distance > 0 ? straight_offset : -straight_offset;
+    return this->motion({distance, 0, 0}, max_speed, chained, options);
+}
+
+void Holonomic::turn(int target_angle, int max_speed){
+    this->turnAsync(target_angle, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::turnAsync(float target_angle, int max_speed){
+    target_angle += target_angle > 0 ? turn_offset : -turn_offset;
+    return this->motion({0, 0, (float)(target_angle*M_PI/180)}, max_speed, false);
+}
+
+Completion Holonomic::turnAsync(float target_angle, int max_speed, const MoveOptions& options){
+    target_angle += target_angle > 0 ? turn_offset : -turn_offset;
+    return this->motion({0, 0, (float)(target_angle*M_PI/180)}, max_speed, false, options);
+}
+
+void Holonomic::turnChained(float target_angle, int max_speed){
+    target_angle += target_angle > 0 ? turn_offset : -turn_offset;
+    this->motion({0, 0, (float)(target_angle*M_PI/180)}, max_speed, true);
+    this->waitUntilSettled();
+}
+
+void Holonomic::strafe(float distance, int max_speed){
+    this->strafeAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::strafeAsync(float distance, int max_speed){
+    return this->strafeInches(Conversion::standardize(distance, this->measure_units), max_speed, false);
+}
+
+Completion Holonomic::strafeAsync(float distance, int max_speed, const MoveOptions& options){
+    float inches = Conversion::standardize(1, this->measure_units);
+    return this->strafeInches(distance * inches, max_speed, false, options.scaled(inches));
+}
+
+void Holonomic::strafeChained(float distance, int max_speed){
+    this->strafeInches(Conversion::standardize(distance, this->measure_units), max_speed, true);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::strafeInches(float distance, int max_speed, bool chained, const MoveOptions& options){
+    distance += distance > 0 ? strafe_offset : -strafe_offset;
+    return this->motion({0, distance, 0}, max_speed, chained, options);
+}
+
+void Holonomic::move(float forward, float lateral, float angle, int max_speed){
+    this->moveAsync(forward, lateral, angle, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::moveAsync(float forward, float lateral, float angle, int max_speed){
+    float inches = Conversion::standardize(1, this->measure_units);
+    return this->motion({forward * inches, lateral * inches, (float)(angle*M_PI/180)}, max_speed, false);
+}
+
+void Holonomic::moveChained(float forward, float lateral, float angle, int max_speed){
+    float inches = Conversion::standardize(1, this->measure_units);
+    this->motion({forward * inches, lateral * inches, (float)(angle*M_PI/180)}, max_speed, true);
+    this->waitUntilSettled();
+}
+
+void Holonomic::straight(Length distance, int max_speed){
+    this->straightAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::straightAsync(Length distance, int max_speed){
+    return this->straightInches(distance.in(), max_speed, false);
+}
+
+Completion Holonomic::straightAsync(Length distance, int max_speed, const MoveOptions& options){
+    // trigger distances are in inches, like the distance
+    return this->straightInches(distance.in(), max_speed, false, options);
+}
+
+void Holonomic::straightChained(Length distance, int max_speed){
+    this->straightInches(distance.in(), max_speed, true);
+    this->waitUntilSettled();
+}
+
+void Holonomic::turn(Angle target_angle, int max_speed){
+    this->turnAsync(target_angle, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::turnAsync(Angle target_angle, int max_speed){
+    return this->turnAsync(target_angle.deg(), max_speed);
+}
+
+Completion Holonomic::turnAsync(Angle target_angle, int max_speed, const MoveOptions& options){
+    return this->turnAsync(target_angle.deg(), max_speed, options);
+}
+
+void Holonomic::turnChained(Angle target_angle, int max_speed){
+    this->turnChained(target_angle.deg(), max_speed);
+}
+
+void Holonomic::strafe(Length distance, int max_speed){
+    this->strafeAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::strafeAsync(Length distance, int max_speed){
+    return this->strafeInches(distance.in(), max_speed, false);
+}
+
+Completion Holonomic::strafeAsync(Length distance, int max_speed, const MoveOptions& options){
+    return this->strafeInches(distance.in(), max_speed, false, options);
+}
+
+void Holonomic::strafeChained(Length distance, int max_speed){
+    this->strafeInches(distance.in(), max_speed, true);
+    this->waitUntilSettled();
+}
+
+void Holonomic::move(Length forward, Length lateral, Angle angle, int max_speed){
+    this->moveAsync(forward, lateral, angle, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::moveAsync(Length forward, Length lateral, Angle angle, int max_speed){
+    return this->motion({forward.in(), lateral.in(), angle.rad()}, max_speed, false);
+}
+
+void Holonomic::moveChained(Length forward, Length lateral, Angle angle, int max_speed){
+    this->motion({forward.in(), lateral.in(), angle.rad()}, max_speed, true);
+    this->waitUntilSettled();
+}
+
+Completion Holonomic::motion(BodyMotion motion, int max_speed, bool chained, const MoveOptions& options){
+    bool turning = motion.rotation != 0;
+    bool translating = motion.forward != 0 || motion.lateral != 0;
+    PID pid = pidStraight;
+    if(turning && !translating) {pid = pidTurn;}
+    if(!turning && motion.forward == 0 && motion.lateral != 0) {pid = pidStrafe;}
+
+    Mechanism* wheels[] = {left, right, back_left, back_right};
+    for(Mechanism* wheel : wheels){
+        wheel->setPID(pid.copy());
+    }
+
+    float distance = std::sqrt(motion.forward*motion.forward + motion.lateral*motion.lateral);
+    float exit_error = -1;
+    if(chained && (turning || translating)){
+        // the wheel error when the body is within the chain tolerance along the same motion
+        float tolerance = motion.forward == 0 ? strafe_chain_tolerance : straight_chain_tolerance;
+        float scale = translating ? tolerance / distance : (turn_chain_tolerance*M_PI/180) / std::fabs(motion.rotation);
+        Drivetrain<HolonomicKinematics>::Wheels error = drive.targets({motion.forward*scale, motion.lateral*scale, motion.rotation*scale});
+        exit_error = 0;
+        for(int i = 0; i < HolonomicKinematics::WHEELS; i++){
+            exit_error = std::fmax(exit_error, std::fabs(error[i]));
+        }
+    }
+    // trigger distances are along the translation, or the angle of a pure turn
+    float amount = translating ? distance : std::fabs(motion.rotation) * 180 / M_PI;
+    return drive.moveBy(motion, max_speed, exit_error, options, amount);
+}
+
+void Holonomic::followPath(const Path& path, int max_speed, float lookahead){
+    static const int path_id = Registry::intern("PATH");
+    static const int path_turn_id = Registry::intern("PATH_TURN");
+    if(path.size() == 0){
+        LOG(WARN) << "Cannot follow an empty path";
+        return;
+    }
+    PurePursuit follower = PurePursuit(&path, lookahead);
+    PID pid = pidStraight.copy();
+    PID heading_pid = pidTurn.copy();
+    float radius = drive.getKinematics().turnRadius();
+    float error = 999;
+    int speed = 999;
+    drive.resetOdometry();
+
+    LOG(DEBUG) << "following path of length " << path.length() << " with max speed " << max_speed;
+
+    while(pid.unfinished(error, speed)){
+        // wheel odometry since the last tick, in inches
+        BodyMotion moved = drive.odometry();
+        follower.update(moved.forward, moved.lateral, moved.rotation);
+
+        // slow down over the remaining length, limited by the path's velocity at this point
+        error = (follower.remaining() / wheel_circumference) * 360.0;
+        float limit = max_speed * path.at(follower.getClosestIndex()).velocity;
+        speed = pid.calculateSpeed(error, limit, path_id);
+
+        // translate towards the lookahead point
+        Point target = follower.lookaheadLocal();
+        float distance = std::sqrt(target.x*target.x + target.y*target.y);
+        float forward_speed = distance > 0 ? speed * target.y / distance : 0;
+        float lateral_speed = distance > 0 ? speed * target.x / distance : 0;
+
+        // hold the starting heading, in the same wheel degrees as turnAsync targets
+        float heading_error = (radius * -follower.getPose().heading / wheel_circumference) * 360;
+        float turn_speed = heading_pid.calculateSpeed(heading_error, max_speed, path_turn_id);
+
+        drive.spin({forward_speed, lateral_speed, radius > 0 ? turn_speed / radius : 0}, max_speed);
+        this_thread::sleep_for(pid.getDelayTime());
+    }
+
+    LOG(DEBUG) << "Finished path with " << follower.remaining() << " inches remaining";
+    this->stop();
+    pid.reset();
+    heading_pid.reset();
+}
+
+void Holonomic::stop(){
+    left->stop();
+    right->stop();
+    back_left->stop();
+    back_right->stop();
+}
+
+void Holonomic::waitUntilSettled(){
+    this->left->waitUntilSettled();
+    this->right->waitUntilSettled();
+    this->back_left->waitUntilSettled();
+    this->back_right->waitUntilSettled();
+}
+
+float Holonomic::getLeftPosition(rotationUnits units){
+    return (left->getPosition(units) + back_left->getPosition(units)) / 2;
+}
+
+float Holonomic::getRightPosition(rotationUnits units){
+    return (right->getPosition(units) + back_right->getPosition(units)) / 2;
+}
+
+void Holonomic::resetPosition(){
+    left->resetPosition();
+    right->resetPosition();
+    back_left->resetPosition();
+    back_right->resetPosition();
+}
+
+void Holonomic::setBrakeType(brakeType type){
+    left->setBrakeType(type);
+    right->setBrakeType(type);
+    back_left->setBrakeType(type);
+    back_right->setBrakeType(type);
+}
+
+void Holonomic::setMaxAcceleration(float max_accel){
+    if(max_accel < 0)
+        LOG(WARN) << "Negative accelerations not allowed";
+    this->left->setMaxAcceleration(max_accel);
+    this->right->setMaxAcceleration(max_accel);
+    this->back_left->setMaxAcceleration(max_accel);
+    this->back_right->setMaxAcceleration(max_accel);
+}
+
+void Holonomic::setVoltageCompensation(float nominal){
+    this->left->setVoltageCompensation(nominal);
+    this->right->setVoltageCompensation(nominal);
+    this->back_left->setVoltageCompensation(nominal);
+    this->back_right->setVoltageCompensation(nominal);
+}
+
+void Holonomic::setThermalLimit(float start, float limit, float min_scale, float max_current){
+    this->left->setThermalLimit(start, limit, min_scale, max_current);
+    this->right->setThermalLimit(start, limit, min_scale, max_current);
+    this->back_left->setThermalLimit(start, limit, min_scale, max_current);
+    this->back_right->setThermalLimit(start, limit, min_scale, max_current);
+}
+
+void Holonomic::setCascade(PID velocity_pid, float max_velocity){
+    this->left->setCascade(velocity_pid, max_velocity);
+    this->right->setCascade(velocity_pid, max_velocity);
+    this->back_left->setCascade(velocity_pid, max_velocity);
+    this->back_right->setCascade(velocity_pid, max_velocity);
+}
+
+void Holonomic::setOffset(float straight, float turn, float strafe){
+    straight_offset = straight;
+    turn_offset = turn;
+    strafe_offset = strafe;
+}
+
+void Holonomic::setChainTolerance(float straight, float turn, float strafe){
+    if(straight < 0 || turn < 0 || strafe < 0)
+        LOG(WARN) << "Negative chain tolerances not allowed";
+    straight_chain_tolerance = straight;
+    turn_chain_tolerance = turn;
+    strafe_chain_tolerance = strafe;
+}
+
+void Holonomic::setTimeout(int timeout){
+    this->pidStraight.setTimeout(timeout);
+    this->pidTurn.setTimeout(timeout);
+    this->pidStrafe.setTimeout(timeout);
+}
+
+void Holonomic::setMeasurementUnits(Conversion::measurement preferred_units){
+    this->measure_units = preferred_units;
+    HolonomicKinematics kinematics = base_kinematics.scaled(Conversion::standardize(1, preferred_units));
+    this->drive.setKinematics(kinematics);
+    this->track_width = 2 * kinematics.turnRadius();
+    this->wheel_circumference = kinematics.circumference(0);
+}
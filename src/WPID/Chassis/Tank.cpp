@@ -13,9 +13,12 @@ Tank::Tank(float track_width, float wheel_radius, vex::motor_group* left, vex::m
     
     this->track_width = track_width;
     this->wheel_circumference = 2.0 * M_PI * wheel_radius;
+    this->base_track_width = this->track_width;
+    this->base_wheel_circumference = this->wheel_circumference;
 
     this->left = new Mechanism(left, drive_gear_ratio,   "LEFT ");
     this->right = new Mechanism(right, drive_gear_ratio, "RIGHT");
+    this->drive = Drivetrain<TankKinematics>(TankKinematics(this->track_width, this->wheel_circumference), {this->left, this->right});
 }
 
 void Tank::setStraightPID(PID pid){
@@ -40,17 +43,30 @@ void Tank::straight(float distance, int max_speed){
     this->waitUntilSettled();
 }
 
-void Tank::straightAsync(float distance, int max_speed){
+Completion Tank::straightAsync(float distance, int max_speed){
     distance = Conversion::standardize(distance, this->measure_units);
+    return this->straightMotion(distance, max_speed, -1);
+}
+
+Completion Tank::straightAsync(float distance, int max_speed, const MoveOptions& options){
+    float inches = Conversion::standardize(1, this->measure_units);
+    // trigger distances are in the same units as the distance
+    return this->straightMotion(distance * inches, max_speed, -1, options.scaled(inches));
+}
+
+void Tank::straightChained(float distance, int max_speed){
+    this->straightChained(Length(Conversion::standardize(distance, this->measure_units)), max_speed);
+}
+
+Completion Tank::straightMotion(float distance, int max_speed, float exit_error, const MoveOptions& options){
     if(distance > 0){
         distance += straight_offset;
     } else {
         distance -= straight_offset;
     }
-    float target = ((distance) / wheel_circumference) * 360.0;
     left->setPID(pidStraight.copy());
     right->setPID(pidStraight.copy());
-    this->spinToTarget(target, target, max_speed, max_speed);
+    return drive.moveBy({distance, 0, 0}, max_speed, exit_error, options, std::fabs(distance));
 }
 
 void Tank::turn(int target_angle, int max_speed){
@@ -58,22 +74,101 @@ void Tank::turn(int target_angle, int max_speed){
     this->waitUntilSettled();
 }
 
-void Tank::turnAsync(float target_angle, int max_speed){
+Completion Tank::turnAsync(float target_angle, int max_speed){
+    return this->turnMotion(target_angle, max_speed, -1);
+}
+
+Completion Tank::turnAsync(float target_angle, int max_speed, const MoveOptions& options){
+    return this->turnMotion(target_angle, max_speed, -1, options);
+}
+
+void Tank::turnChained(float target_angle, int max_speed){
+    float tolerance = ((track_width/2)*(turn_chain_tolerance*M_PI/180)/wheel_circumference)*360;
+    this->turnMotion(target_angle, max_speed, tolerance);
+    this->waitUntilSettled();
+}
+
+Completion Tank::turnMotion(float target_angle, int max_speed, float exit_error, const MoveOptions& options){
     if(target_angle > 0){
         target_angle += turn_offset;
     } else {
         target_angle -= turn_offset;
     }
-    float target = ((track_width/2)*((float)(target_angle)*M_PI/180)/wheel_circumference)*360;
     left->setPID(pidTurn.copy());
     right->setPID(pidTurn.copy());
-    this->spinToTarget(target, -target, max_speed, max_speed);
+    return drive.moveBy({0, 0, (float)(target_angle*M_PI/180)}, max_speed, exit_error, options, std::fabs(target_angle));
+}
+
+void Tank::straight(Length distance, int max_speed){
+    this->straightAsync(distance, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Tank::straightAsync(Length distance, int max_speed){
+    return this->straightMotion(distance.in(), max_speed, -1);
+}
+
+Completion Tank::straightAsync(Length distance, int max_speed, const MoveOptions& options){
+    // trigger distances are in inches, like the distance
+    return this->straightMotion(distance.in(), max_speed, -1, options);
+}
+
+void Tank::straightChained(Length distance, int max_speed){
+    float tolerance = (straight_chain_tolerance / wheel_circumference) * 360.0;
+    this->straightMotion(distance.in(), max_speed, tolerance);
+    this->waitUntilSettled();
+}
+
+void Tank::turn(Angle target_angle, int max_speed){
+    this->turnAsync(target_angle, max_speed);
+    this->waitUntilSettled();
+}
+
+Completion Tank::turnAsync(Angle target_angle, int max_speed){
+    return this->turnMotion(target_angle.deg(), max_speed, -1);
+}
+
+Completion Tank::turnAsync(Angle target_angle, int max_speed, const MoveOptions& options){
+    return this->turnMotion(target_angle.deg(), max_speed, -1, options);
 }
 
-void Tank::spinToTarget(float left_target, float right_target, int l_max_spd, int r_max_spd){    
-    left->moveRelativeAsync(left_target, l_max_spd);
-    right->moveRelativeAsync(right_target, r_max_spd);
-}   
+void Tank::turnChained(Angle target_angle, int max_speed){
+    this->turnChained(target_angle.deg(), max_speed);
+}
+
+void Tank::followPath(const Path& path, int max_speed, float lookahead){
+    static const int path_id = Registry::intern("PATH");
+    if(path.size() == 0){
+        LOG(WARN) << "Cannot follow an empty path";
+        return;
+    }
+    PurePursuit follower = PurePursuit(&path, lookahead);
+    PID pid = pidStraight.copy();
+    float error = 999;
+    int speed = 999;
+    drive.resetOdometry();
+
+    LOG(DEBUG) << "following path of length " << path.length() << " with max speed " << max_speed;
+
+    while(pid.unfinished(error, speed)){
+        // wheel odometry since the last tick, in inches
+        BodyMotion moved = drive.odometry();
+        follower.update(moved.forward, moved.lateral, moved.rotation);
+
+        // slow down over the remaining length, limited by the path's velocity at this point
+        error = (follower.remaining() / wheel_circumference) * 360.0;
+        float limit = max_speed * path.at(follower.getClosestIndex()).velocity;
+        speed = pid.calculateSpeed(error, limit, path_id);
+
+        // steer along the arc to the lookahead point
+        drive.spin({(float)speed, 0, speed * follower.curvature()}, max_speed);
+        this_thread::sleep_for(pid.getDelayTime());
+    }
+
+    LOG(DEBUG) << "Finished path with " << follower.remaining() << " inches remaining";
+    this->stop();
+    pid.reset();
+}
 
 void Tank::stop(){
     left->stop();
@@ -108,6 +203,13 @@ void Tank::setOffset(float straight, float turn){
     turn_offset = turn;
 }
 
+void Tank::setChainTolerance(float straight, float turn){
+    if(straight < 0 || turn < 0)
+        LOG(WARN) << "Negative chain tolerances not allowed";
+    straight_chain_tolerance = straight;
+    turn_chain_tolerance = turn;
+}
+
 void Tank::setMaxAcceleration(float max_accel){
     if(max_accel < 0)
         LOG(WARN) << "Negative accelerations not allowed";
@@ -115,6 +217,21 @@ void Tank::setMaxAcceleration(float max_accel){
     this->right->setMaxAcceleration(max_accel);
 }
 
+void Tank::setVoltageCompensation(float nominal){
+    this->left->setVoltageCompensation(nominal);
+    this->right->setVoltageCompensation(nominal);
+}
+
+void Tank::setThermalLimit(float start, float limit, float min_scale, float max_current){
+    this->left->setThermalLimit(start, limit, min_scale, max_current);
+    this->right->setThermalLimit(start, limit, min_scale, max_current);
+}
+
+void Tank::setCascade(PID velocity_pid, float max_velocity){
+    this->left->setCascade(velocity_pid, max_velocity);
+    this->right->setCascade(velocity_pid, max_velocity);
+}
+
 void Tank::setTimeout(int timeout){
     this->pidStraight.setTimeout(timeout);
     this->pidTurn.setTimeout(timeout);
@@ -122,6 +239,7 @@ void Tank::setTimeout(int timeout){
 
 void Tank::setMeasurementUnits(Conversion::measurement preferred_units){
     this->measure_units = preferred_units;
-    this->wheel_circumference = Conversion::standardize(this->wheel_circumference, preferred_units);
-    this->track_width = Conversion::standardize(this->track_width, preferred_units);
+    this->wheel_circumference = Conversion::standardize(this->base_wheel_circumference, preferred_units);
+    this->track_width = Conversion::standardize(this->base_track_width, preferred_units);
+    this->drive.setKinematics(TankKinematics(this->track_width, this->wheel_circumference));
 }
@@ -0,0 +1,64 @@
+#include "WPID/Completion.h"
+
+using namespace vex;
+using namespace wpid;
+
+Completion::Completion(const MoveHandle& move){
+    moves.push_back(move);
+}
+
+Completion::Completion(Mode mode){
+    this->mode = mode;
+}
+
+Completion& Completion::add(const MoveHandle& move){
+    moves.push_back(move);
+    return *this;
+}
+
+Completion& Completion::add(const Completion& part){
+    if(part.moves.empty() && part.children.empty()){
+        // an empty part is already done, which finishes an ANY and changes nothing in an ALL
+        if(mode == Mode::ANY) {children.push_back(part);}
+    } else if(part.mode == mode){
+        moves.insert(moves.end(), part.moves.begin(), part.moves.end());
+        children.insert(children.end(), part.children.begin(), part.children.end());
+    } else {
+        children.push_back(part);
+    }
+    return *this;
+}
+
+bool Completion::done() const{
+    if(moves.empty() && children.empty()) {return true;}
+    bool all = mode == Mode::ALL;
+    for(size_t i = 0; i < moves.size(); i++){
+        bool finished = !moves[i].active();
+        if(all && !finished) {return false;}
+        if(!all && finished) {return true;}
+    }
+    for(size_t i = 0; i < children.size(); i++){
+        bool finished = children[i].done();
+        if(all && !finished) {return false;}
+        if(!all && finished) {return true;}
+    }
+    return all;
+}
+
+bool Completion::wait(int timeout) const{
+    uint32_t start = vex::timer::system();
+    while(!this->done()){
+        if(timeout >= 0 && vex::timer::system() - start >= (uint32_t)timeout) {return false;}
+        this_thread::sleep_for(POLL_TIME);
+    }
+    return true;
+}
+
+void Completion::cancel(){
+    for(size_t i = 0; i < moves.size(); i++){
+        moves[i].cancel();
+    }
+    for(size_t i = 0; i < children.size(); i++){
+        children[i].cancel();
+    }
+}
@@ -0,0 +1,251 @@
+#include "WPID/IO/MotorBus.h"
+
+using namespace vex;
+using namespace wpid;
+
+MotorBus& MotorBus::instance(){
+    static MotorBus bus;
+    return bus;
+}
+
+bool MotorBus::tick(void* data){
+    MotorBus* bus = (MotorBus*)data;
+    bus->sample();
+    bus->flush();
+    return true;
+}
+
+int MotorBus::attach(motor_group* motors){
+    lock.lock();
+    if((int)channels.size() >= MAX_CHANNELS){
+        lock.unlock();
+        LOG(WARN) << "Motor bus is full, only " << MAX_CHANNELS << " motor groups can be attached";
+        return -1;
+    }
+    Channel channel = {motors, {Command::NONE, 0}, {Command::NONE, 0}, false, {0, 0, 0, 0, 0, 0, 0, 0}, StateEstimator(), 0, -1, -1};
+    channels.push_back(channel);
+    int index = channels.size() - 1;
+    if(job == -1){
+        job = Scheduler::instance().add(period, tick, this);
+    }
+    lock.unlock();
+    return index;
+}
+
+void MotorBus::spin(int channel, float velocity){
+    this->command(channel, {Command::VELOCITY, velocity});
+}
+
+void MotorBus::spinVoltage(int channel, float volts){
+    this->command(channel, {Command::VOLTAGE, volts});
+}
+
+void MotorBus::command(int channel, Command command){
+    lock.lock();
+    if(channel < 0 || channel >= (int)channels.size()){
+        lock.unlock();
+        LOG(WARN) << "Motor bus has no channel " << channel;
+        return;
+    }
+    Channel& c = channels[channel];
+    c.pending = command;
+    c.dirty = true;
+    lock.unlock();
+}
+
+void MotorBus::setCurrentLimit(int channel, float amps){
+    lock.lock();
+    if(channel < 0 || channel >= (int)channels.size()){
+        lock.unlock();
+        LOG(WARN) << "Motor bus has no channel " << channel;
+        return;
+    }
+    channels[channel].limit = amps;
+    lock.unlock();
+}
+
+void MotorBus::stop(int channel){
+    lock.lock();
+    if(channel < 0 || channel >= (int)channels.size()){
+        lock.unlock();
+        LOG(WARN) << "Motor bus has no channel " << channel;
+        return;
+    }
+    Channel& c = channels[channel];
+    c.pending = {Command::STOP, 0};
+    this->write(c);
+    lock.unlock();
+}
+
+void MotorBus::write(Channel& channel){
+    channel.dirty = false;
+    if(channel.pending == channel.written){
+        suppressed++;
+        return;
+    }
+    switch(channel.pending.type){
+        case Command::VELOCITY: channel.motors->spin(directionType::fwd, channel.pending.value, velocityUnits::pct); break;
+        case Command::VOLTAGE:  channel.motors->spin(directionType::fwd, channel.pending.value, voltageUnits::volt); break;
+        case Command::STOP:     channel.motors->stop(); break;
+        default: return;
+    }
+    channel.written = channel.pending;
+    writes++;
+}
+
+void MotorBus::flush(){
+    lock.lock();
+    for(size_t i = 0; i < channels.size(); i++){
+        Channel& c = channels[i];
+        if(c.dirty) {this->write(c);}
+        if(c.limit >= 0 && c.limit != c.written_limit){
+            c.motors->setMaxTorque(c.limit, currentUnits::amp);
+            c.written_limit = c.limit;
+            writes++;
+        }
+    }
+    lock.unlock();
+}
+
+MotorBus::Reading MotorBus::measure(motor_group* motors){
+    Reading reading;
+    reading.position = motors->position(rotationUnits::deg);
+    reading.velocity = motors->velocity(velocityUnits::rpm);
+    reading.current = motors->current(currentUnits::amp);
+    reading.temperature = motors->temperature(temperatureUnits::celsius);
+    return reading;
+}
+
+void MotorBus::store(Channel& channel, const Reading& reading, uint64_t now){
+    // another task may have stored a newer reading while this one was taken
+    if(channel.sample.time != 0 && channel.sample.time >= now) {return;}
+    channel.sample.position = reading.position;
+    channel.sample.velocity = reading.velocity;
+    // a sample thrown away by invalidate() means the encoders jumped, so the estimate starts over
+    if(channel.sample.time == 0) {channel.estimator.reset(channel.sample.position, now);}
+    else {channel.estimator.update(channel.sample.position, now);}
+    // degrees per second to rpm
+    channel.sample.filtered_velocity = channel.estimator.getVelocity() / 6.0f;
+    channel.sample.acceleration = channel.estimator.getAcceleration() / 6.0f;
+    channel.sample.current = reading.current;
+    channel.sample.temperature = reading.temperature;
+    channel.sample.battery = battery;
+    channel.sample.time = now;
+    reads++;
+}
+
+void MotorBus::sample(){
+    // copy out what to read, then talk to the devices without holding the lock
+    motor_group* motors[MAX_CHANNELS];
+    uint32_t generations[MAX_CHANNELS];
+    lock.lock();
+    int count = channels.size();
+    for(int i = 0; i < count; i++){
+        motors[i] = channels[i].motors;
+        generations[i] = channels[i].generation;
+    }
+    lock.unlock();
+
+    Reading readings[MAX_CHANNELS];
+    uint64_t now = timer::systemHighResolution();
+    float volts = power.voltage(voltageUnits::volt);
+    for(int i = 0; i < count; i++){
+        readings[i] = measure(motors[i]);
+    }
+
+    lock.lock();
+    battery = volts;
+    for(int i = 0; i < count; i++){
+        if(channels[i].generation == generations[i]) {this->store(channels[i], readings[i], now);}
+    }
+    lock.unlock();
+}
+
+MotorBus::Sample MotorBus::getSample(int channel){
+    lock.lock();
+    if(channel < 0 || channel >= (int)channels.size()){
+        lock.unlock();
+        LOG(WARN) << "Motor bus has no channel " << channel;
+        Sample empty = {0, 0, 0, 0, 0, 0, 0, 0};
+        return empty;
+    }
+    Channel& c = channels[channel];
+    uint64_t now = timer::systemHighResolution();
+    if(c.sample.time != 0 && now - c.sample.time <= max_age){
+        Sample sample = c.sample;
+        lock.unlock();
+        return sample;
+    }
+
+    // too old, read it again without holding up the other channels
+    motor_group* motors = c.motors;
+    uint32_t generation = c.generation;
+    lock.unlock();
+    Reading reading = measure(motors);
+
+    lock.lock();
+    Channel& fresh = channels[channel];
+    if(fresh.generation == generation) {this->store(fresh, reading, now);}
+    Sample sample = fresh.sample;
+    lock.unlock();
+    return sample;
+}
+
+void MotorBus::invalidate(int channel){
+    lock.lock();
+    if(channel >= 0 && channel < (int)channels.size()){
+        channels[channel].sample.time = 0;
+        channels[channel].generation++;
+    }
+    lock.unlock();
+}
+
+void MotorBus::setEstimator(int channel, const StateEstimator& estimator){
+    lock.lock();
+    if(channel < 0 || channel >= (int)channels.size()){
+        lock.unlock();
+        LOG(WARN) << "Motor bus has no channel " << channel;
+        return;
+    }
+    channels[channel].estimator = estimator;
+    channels[channel].sample.time = 0;
+    channels[channel].generation++;
+    lock.unlock();
+}
+
+void MotorBus::setMaxSampleAge(uint64_t max_age){
+    this->max_age = max_age;
+}
+
+void MotorBus::setPeriod(int period){
+    if(period <= 0){
+        LOG(WARN) << "Motor bus period must be positive";
+        return;
+    }
+    lock.lock();
+    this->period = period;
+    // move the bus to the rate group for its new period
+    if(job != -1){
+        Scheduler::instance().remove(job);
+        job = Scheduler::instance().add(period, tick, this);
+    }
+    lock.unlock();
+}
+
+uint32_t MotorBus::getWrites() const{
+    return writes;
+}
+
+uint32_t MotorBus::getSuppressed() const{
+    return suppressed;
+}
+
+uint32_t MotorBus::getReads() const{
+    return reads;
+}
+
+void MotorBus::resetCounters(){
+    writes = 0;
+    suppressed = 0;
+    reads = 0;
+}
@@ -0,0 +1,104 @@
+#include "WPID/IO/StateEstimator.h"
+
+using namespace wpid;
+
+StateEstimator::StateEstimator(){
+    *this = fadingMemory(0.7);
+}
+
+StateEstimator::StateEstimator(float alpha, float beta, float gamma) : alpha(alpha), beta(beta), gamma(gamma){
+    if(alpha <= 0 || alpha > 1 || beta < 0 || gamma < 0)
+        LOG(WARN) << "State estimator gains " << alpha << ", " << beta << ", " << gamma << " are not stable";
+}
+
+StateEstimator StateEstimator::fadingMemory(float theta){
+    if(theta < 0 || theta >= 1){
+        LOG(WARN) << "Fading memory must be from 0 to below 1, not " << theta;
+        theta = theta < 0 ? 0 : 0.99;
+    }
+    float keep = 1 - theta;
+    return StateEstimator(1 - theta*theta*theta, 1.5f * keep*keep * (1 + theta), 0.5f * keep*keep*keep);
+}
+
+StateEstimator StateEstimator::fromNoise(float process_noise, float measurement_noise, float period){
+    if(process_noise <= 0 || measurement_noise <= 0 || period <= 0){
+        LOG(WARN) << "State estimator noise and period must be positive";
+        return StateEstimator();
+    }
+    // constant acceleration model with white noise jerk, iterated to the steady state gain
+    double t = period / 1000.0;
+    double q = (double)process_noise * process_noise;
+    double r = (double)measurement_noise * measurement_noise;
+    double f[3][3] = {{1, t, t*t/2}, {0, 1, t}, {0, 0, 1}};
+    double noise[3][3] = {
+        {q*t*t*t*t*t/20, q*t*t*t*t/8, q*t*t*t/6},
+        {q*t*t*t*t/8,    q*t*t*t/3,   q*t*t/2},
+        {q*t*t*t/6,      q*t*t/2,     q*t}};
+    double p[3][3] = {{r, 0, 0}, {0, r/(t*t), 0}, {0, 0, r/(t*t*t*t)}};
+    double k[3] = {1, 0, 0};
+    for(int iteration = 0; iteration < 1000; iteration++){
+        // predict, P = F P Fᵀ + Q
+        double fp[3][3] = {};
+        for(int i = 0; i < 3; i++)
+            for(int j = 0; j < 3; j++)
+                for(int c = 0; c < 3; c++) {fp[i][j] += f[i][c] * p[c][j];}
+        for(int i = 0; i < 3; i++){
+            for(int j = 0; j < 3; j++){
+                double sum = noise[i][j];
+                for(int c = 0; c < 3; c++) {sum += fp[i][c] * f[j][c];}
+                p[i][j] = sum;
+            }
+        }
+        // correct with a position reading, K = P Hᵀ / (H P Hᵀ + R)
+        double previous = k[0];
+        double s = p[0][0] + r;
+        for(int i = 0; i < 3; i++) {k[i] = p[i][0] / s;}
+        double row[3] = {p[0][0], p[0][1], p[0][2]};
+        for(int i = 0; i < 3; i++)
+            for(int j = 0; j < 3; j++) {p[i][j] -= k[i] * row[j];}
+        if(iteration > 10 && std::fabs(k[0] - previous) < 1e-9) {break;}
+    }
+    return StateEstimator(k[0], k[1] * t, k[2] * t*t / 2);
+}
+
+void StateEstimator::reset(float position, uint64_t time){
+    this->position = position;
+    velocity = 0;
+    acceleration = 0;
+    last_time = time;
+}
+
+void StateEstimator::update(float position, uint64_t time){
+    if(last_time == 0) {this->reset(position, time); return;}
+    if(time <= last_time) {return;}
+    float dt = (time - last_time) / 1e6f;
+    last_time = time;
+
+    // predict with the motion since the last reading
+    float predicted = this->position + velocity*dt + 0.5f*acceleration*dt*dt;
+    float predicted_velocity = velocity + acceleration*dt;
+
+    // correct each term by its share of the residual
+    float residual = position - predicted;
+    this->position = predicted + alpha * residual;
+    velocity = predicted_velocity + beta / dt * residual;
+    acceleration = acceleration + 2 * gamma / (dt*dt) * residual;
+}
+
+float StateEstimator::getPosition() const{
+    return position;
+}
+
+float StateEstimator::getVelocity() const{
+    return velocity;
+}
+
+float StateEstimator::getAcceleration() const{
+    return acceleration;
+}
+
+void StateEstimator::getGains(float& alpha, float& beta, float& gamma) const{
+    alpha = this->alpha;
+    beta = this->beta;
+    gamma = this->gamma;
+}
@@ -1,5 +1,6 @@
 #include "WPID/Mechanism/Mechanism.h"
 #include <stdlib.h>
+#include <string.h>
 
 using namespace vex;
 using namespace wpid;
@@ -7,37 +8,92 @@ using namespace wpid;
 Mechanism::Mechanism(motor_group* motors, float gear_ratio, std::string mech_id){
     this->motors = motors;
     this->gear_ratio = gear_ratio;
-    this->mech_id = mech_id;
+    this->mech_id = Registry::intern(mech_id);
+    this->channel = MotorBus::instance().attach(motors);
+    PIDLogger::instance().start();
 }
 
 Mechanism::Mechanism(motor_group* motors, float gear_ratio){
     this->motors = motors;
     this->gear_ratio = gear_ratio;
-    this->mech_id = "MECHANISM";
+    this->mech_id = Registry::intern("MECHANISM");
+    this->channel = MotorBus::instance().attach(motors);
+    PIDLogger::instance().start();
 }
 
 void Mechanism::spin(int velocity){
-    float position = this->getPosition(rotationUnits::deg);
-    if((velocity > 0 && position < upper_bound)
-    || (velocity < 0 && position > lower_bound)){
-        motors->spin(directionType::fwd, velocity, velocityUnits::pct);
+    // only read the encoder when there are bounds to check
+    Params params = this->params.read();
+    bool bounded = params.upper_bound != MAXFLOAT || params.lower_bound != -MAXFLOAT;
+    float position = bounded ? this->getPosition(rotationUnits::deg) : 0;
+    bool allowed = (velocity > 0 && position < params.upper_bound)
+                || (velocity < 0 && position > params.lower_bound);
+
+    // a running move owns the output and the state, so only send the command until its next tick
+    if(!this->claim()){
+        if(allowed) {MotorBus::instance().spin(channel, velocity);}
+        else {MotorBus::instance().stop(channel);}
+        return;
+    }
+    chained = false;
+    if(allowed){
+        this->output(velocity, params);
     } else {
-        motors->stop();
+        MotorBus::instance().stop(channel);
+        velocity = 0;
     }
+    move.published.output = velocity;
+    move.published.time = vex::timer::system();
+    this->state.publish(move.published);
+    this->unclaim();
 }
 
 void Mechanism::stop(){
-    motors->stop();
+    // a running move stops the motors and publishes its end on its next tick
+    MoveHandle(this, move.id).cancel();
+    MotorBus::instance().stop(channel);
+    if(!this->claim()) {return;}
+    this->halt();
+    move.published.time = vex::timer::system();
+    this->state.publish(move.published);
+    this->unclaim();
+}
+
+void Mechanism::halt(){
+    chained = false;
+    carry_speed = 0;
+    MotorBus::instance().stop(channel);
+    move.published.output = 0;
+}
+
+bool Mechanism::claim(){
+    bool idle = true;
+    return move.done.compare_exchange_strong(idle, false);
+}
+
+void Mechanism::unclaim(){
+    uint32_t ticking = move.ticking;
+    move.done = true;
+    // a move posted meanwhile saw the mechanism busy, so its thread is scheduled from here
+    if(move.id != ticking) {this->wake(false);}
 }
 
 void Mechanism::waitUntilSettled(){
-    this->mech_thread->join();
-    delete(this->mech_thread);
+    while(history[move.id % HISTORY] == MoveStatus::RUNNING) {this_thread::sleep_for(1);}
+}
+
+MoveHandle Mechanism::moveRelativeAsync(float position, float max_speed, float exit_error){
+    return this->moveRelativeAsync(position, max_speed, MoveOptions(), exit_error);
 }
 
-void Mechanism::moveRelativeAsync(float position, float max_speed){
-    float current = this->getPosition(deg);
-    this->moveAbsoluteAsync(position + current, max_speed);
+MoveHandle Mechanism::moveRelativeAsync(float position, float max_speed, const MoveOptions& options, float exit_error){
+    float current = chained ? chain_target.load() : this->getPosition(deg);
+    return this->moveAbsoluteAsync(position + current, max_speed, options, exit_error);
+}
+
+void Mechanism::moveRelativeChained(float position, float max_speed, float exit_error){
+    this->moveRelativeAsync(position, max_speed, exit_error);
+    this->waitUntilSettled();
 }
 
 void Mechanism::moveRelative(float position, float max_speed){
@@ -45,9 +101,175 @@ void Mechanism::moveRelative(float position, float max_speed){
     this->waitUntilSettled();
 }
 
-void Mechanism::moveAbsoluteAsync(float position, float max_speed){  
-    void* arg = (void*)getParams(position, max_speed);
-    this->mech_thread = new thread(spinToTarget, arg);
+MoveHandle Mechanism::moveAbsoluteAsync(float position, float max_speed, float exit_error){
+    return this->moveAbsoluteAsync(position, max_speed, MoveOptions(), exit_error);
+}
+
+MoveHandle Mechanism::moveAbsoluteAsync(float position, float max_speed, const MoveOptions& options, float exit_error){
+    Request request = {max_speed, exit_error, options, false};
+    return this->start(position, request);
+}
+
+MoveHandle Mechanism::start(float target, const Request& request){
+    // claim the next id, marking it running before a handle can look it up
+    uint32_t id = move.id;
+    do {history[(id + 1) % HISTORY] = MoveStatus::RUNNING;}
+    while(!move.id.compare_exchange_weak(id, id + 1));
+    id++;
+
+    // the target goes in straight away so retarget() works before the move starts, unless a newer move's is already there
+    uint64_t packed = move.target;
+    while((int32_t)((uint32_t)(packed >> 32) - id) < 0
+          && !move.target.compare_exchange_weak(packed, packTarget(id, target))) {}
+
+    // post the rest for the move thread, which starts the newest whole request on its next run
+    Posted& slot = requests[id % HISTORY];
+    slot.id.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.request = request;
+    slot.id.store(id, std::memory_order_release);
+
+    // a running move thread hands over by itself, otherwise this task schedules one
+    this->wake(request.velocity_mode);
+    return MoveHandle(this, id);
+}
+
+void Mechanism::wake(bool velocity_mode){
+    bool idle = true;
+    while(move.done.compare_exchange_strong(idle, false)){
+        int outer_ticks;
+        if(this->schedule(periodOf(this->params.read(), velocity_mode, outer_ticks))) {break;}
+        // the rate group is full, so cancel every move waiting to start, including any posted meanwhile
+        uint32_t newest = move.id;
+        for(int i = 0; i < HISTORY; i++){
+            MoveStatus running = MoveStatus::RUNNING;
+            history[i].compare_exchange_strong(running, MoveStatus::CANCELLED);
+        }
+        move.done = true;
+        if(move.id == newest) {break;}
+        idle = true;
+    }
+}
+
+bool Mechanism::take(uint32_t id, Request& request){
+    Posted& slot = requests[id % HISTORY];
+    if(slot.id.load(std::memory_order_acquire) != id) {return false;}
+    request = slot.request;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.id.load(std::memory_order_relaxed) == id;
+}
+
+void Mechanism::launch(uint32_t id, const Request& request){
+    move.ticking = id;
+    move.running = true;
+    move.max_speed = request.max_speed;
+    move.exit_error = request.exit_error;
+    move.options = request.options;
+    move.velocity_mode = request.velocity_mode;
+    chained = false;
+    if(request.velocity_mode){
+        this->beginVelocity();
+    } else {
+        this->begin();
+    }
+}
+
+bool Mechanism::schedule(int period){
+    // set before the job exists, so its first run sees the period it runs at
+    int previous = move.job_period;
+    move.job_period = period;
+    if(Scheduler::instance().add(period, run, (void*)this) != -1) {return true;}
+    move.job_period = previous;
+    return false;
+}
+
+bool Mechanism::release(){
+    uint32_t ticking = move.ticking;
+    move.done = true;
+    // a move posted before done was set saw this thread still scheduled, so this thread starts it
+    if(move.id == ticking) {return false;}
+    bool idle = true;
+    return move.done.compare_exchange_strong(idle, false);
+}
+
+int Mechanism::periodOf(const Params& params, bool velocity_mode, int& outer_ticks){
+    outer_ticks = 1;
+    if(velocity_mode) {return params.controller.period;}
+    // a cascaded move ticks at the velocity loop's rate, running the position loop every few ticks
+    int period = params.pid.delay_time;
+    int inner = params.velocity_pid.delay_time;
+    if(!params.cascaded || inner <= 0 || inner >= period) {return period;}
+    outer_ticks = (period + inner / 2) / inner;
+    return outer_ticks > 1 ? inner : period;
+}
+
+bool Mechanism::run(void* args){
+    Mechanism* mech = (Mechanism*)args;
+    Move& move = mech->move;
+    uint32_t newest = move.id;
+    if(newest != move.ticking){
+        Request request;
+        if(mech->take(newest, request)){
+            if(move.running) {mech->finish(MoveStatus::PREEMPTED);}
+            // moves posted after the last one this thread started were overtaken before their first tick
+            for(uint32_t id = newest - 1; id != move.ticking && newest - id < (uint32_t)HISTORY; id--){
+                mech->history[id % HISTORY] = MoveStatus::PREEMPTED;
+            }
+            mech->launch(newest, request);
+            // a move at another rate carries on in a job of its own
+            if(move.period != move.job_period && mech->schedule(move.period)) {return false;}
+        } else if(!move.running){
+            return true; // the move is still being posted
+        }
+    }
+    bool running = move.velocity_mode ? velocityTick(args) : tick(args);
+    return running || mech->release();
+}
+
+void Mechanism::setVelocityController(const VelocityController& controller){
+    // only the settings are published, the move thread builds its own controller from them
+    const VelocityConfig& config = controller.getConfig();
+    this->params.update([&config](Params& p){
+        p.controller = config;
+        p.controller_version++;
+    });
+}
+
+MoveHandle Mechanism::spinVelocity(float velocity){
+    Request request = {100, -1, MoveOptions(), true};
+    return this->start(velocity, request);
+}
+
+void Mechanism::beginVelocity(){
+    float velocity = unpackTarget(move.target);
+    move.requested = velocity;
+    move.cascaded = false;
+    move.error = 0;
+    move.final_speed = carry_speed;
+
+    // a new controller starts fresh, otherwise keep spinning from the last velocity move
+    Params params = this->params.read();
+    if(velocity_run_version != params.controller_version){
+        this->velocity = VelocityController(params.controller);
+        velocity_run_version = params.controller_version;
+    }
+    this->velocity.start(velocity, vex::timer::system());
+    move.period = this->velocity.getPeriod();
+
+    move.published.target = velocity;
+    move.published.phase = MoveStatus::RUNNING;
+    move.published.move = move.ticking;
+    this->state.publish(move.published);
+    LOG(DEBUG) << "spinning #" << mech_id << " at " << velocity << " rpm";
+}
+
+VelocityMetrics Mechanism::getVelocityMetrics() const{
+    return velocity_metrics.read();
+}
+
+void Mechanism::moveAbsoluteChained(float position, float max_speed, float exit_error){
+    this->moveAbsoluteAsync(position, max_speed, exit_error);
+    this->waitUntilSettled();
 }
 
 void Mechanism::moveAbsolute(float position, float max_speed){
@@ -55,59 +277,355 @@ void Mechanism::moveAbsolute(float position, float max_speed){
     this->waitUntilSettled();
 }
 
-void Mechanism::spinToTarget(void* args){
-    params* input = (params*)args;
-    Mechanism* mech = input->mech;
-    float max_speed = fabs(input->spd); // make sure max_speed is a scalar
-    float target = (input->pos + mech->offset);
+void Mechanism::moveRelative(Angle position, float max_speed){
+    this->moveRelative(position.deg(), max_speed);
+}
+
+MoveHandle Mechanism::moveRelativeAsync(Angle position, float max_speed, Angle exit_error){
+    return this->moveRelativeAsync(position.deg(), max_speed, exit_error.deg());
+}
+
+MoveHandle Mechanism::moveRelativeAsync(Angle position, float max_speed, const MoveOptions& options, Angle exit_error){
+    return this->moveRelativeAsync(position.deg(), max_speed, options, exit_error.deg());
+}
+
+void Mechanism::moveAbsolute(Angle position, float max_speed){
+    this->moveAbsolute(position.deg(), max_speed);
+}
+
+MoveHandle Mechanism::moveAbsoluteAsync(Angle position, float max_speed, Angle exit_error){
+    return this->moveAbsoluteAsync(position.deg(), max_speed, exit_error.deg());
+}
+
+MoveHandle Mechanism::moveAbsoluteAsync(Angle position, float max_speed, const MoveOptions& options, Angle exit_error){
+    return this->moveAbsoluteAsync(position.deg(), max_speed, options, exit_error.deg());
+}
+
+void Mechanism::output(float speed, const Params& params){
+    if(params.thermal_version != thermal_version){
+        // new thermal settings start again from an unthrottled current limit
+        thermal_version = params.thermal_version;
+        thermal_scale = 1;
+    }
+    if(params.nominal_voltage <= 0 && params.thermal_start <= 0){
+        MotorBus::instance().spin(channel, speed);
+        return;
+    }
+    MotorBus::Sample sample = MotorBus::instance().getSample(channel);
+    if(params.thermal_start > 0){
+        this->updateThermalScale(sample.temperature, params);
+        speed *= thermal_scale;
+    }
+    if(params.nominal_voltage <= 0){
+        MotorBus::instance().spin(channel, speed);
+        return;
+    }
+    // the battery can't supply more than it has, so clamp to the last reading
+    float volts = speed / 100.0 * params.nominal_voltage;
+    float battery = sample.battery;
+    if(battery > 0 && fabs(volts) > battery){
+        volts = volts > 0 ? battery : -battery;
+    }
+    MotorBus::instance().spinVoltage(channel, volts);
+}
+
+float Mechanism::thermalScaleAt(float temperature, const Params& params){
+    if(temperature < params.thermal_start) {return 1;}
+    float span = params.thermal_limit - params.thermal_start;
+    float heat = span > 0 ? fmin((temperature - params.thermal_start) / span, 1) : 1;
+    float scale = 1 - heat * (1 - params.thermal_min_scale);
+    return fmax(floor(scale * 20 + 0.001f) / 20, params.thermal_min_scale);
+}
+
+void Mechanism::updateThermalScale(float temperature, const Params& params){
+    float current = thermal_scale;
+    float scale = this->thermalScaleAt(temperature, params);
+    // only raise the scale once the motors are 2 degrees cooler than the step
+    if(scale > current){
+        scale = fmax(this->thermalScaleAt(temperature + 2, params), current);
+    }
+    if(scale == current) {return;}
+
+    if(current == 1){
+        LOG(WARN) << "#" << mech_id << " is at " << temperature << "C, throttling to " << scale * 100 << "%";
+    } else if(scale == 1){
+        LOG(INFO) << "#" << mech_id << " cooled to " << temperature << "C, no longer throttling";
+    } else {
+        LOG(DEBUG) << "#" << mech_id << " is at " << temperature << "C, throttling to " << scale * 100 << "%";
+    }
+    thermal_scale = scale;
+    MotorBus::instance().setCurrentLimit(channel, params.max_current * scale);
+}
+
+float Mechanism::limitTarget(float position, const Params& params){
+    float target = position + params.offset;
 
     //limit target to bounds if calcluations exceed bounds
-    if(target > mech->upper_bound){
-        target = mech->upper_bound;
-        LOG(WARN) << mech->mech_id << "'s upper bound was exceeded, reduced to " << mech->upper_bound;
-    } else if (target < mech->lower_bound) {
-        target = mech->lower_bound;
-        LOG(WARN) << mech->mech_id << "'s lower bound was exceeded, reduced to " << mech->lower_bound;
-    }
-
-    LOG(DEBUG) << "moving " << mech->mech_id << " to " << target << " with max speed " << max_speed;
-
-    float state = 0;
-    float error = 999;
-    float ramp = 0;
-    int calculated_speed = 999;
-    int final_speed;
-
-    while(mech->pid.unfinished(error, calculated_speed)){ // checks if the system is within bounds, low speed, or timed out
-        state = mech->getPosition(rotationUnits::deg); // get the state of the motors
-        error = target - state; // difference between target and state
-       
-        calculated_speed = mech->pid.calculateSpeed(error, max_speed, mech->mech_id); // calculate PID speed
-        
+    if(target > params.upper_bound){
+        target = params.upper_bound;
+        LOG(WARN) << "#" << mech_id << "'s upper bound was exceeded, reduced to " << params.upper_bound;
+    } else if (target < params.lower_bound) {
+        target = params.lower_bound;
+        LOG(WARN) << "#" << mech_id << "'s lower bound was exceeded, reduced to " << params.lower_bound;
+    }
+    return target;
+}
+
+void Mechanism::applyPID(const Params& params){
+    if(params.pid_version != pid_version){
+        pid.setConfig(params.pid);
+        pid_version = params.pid_version;
+    }
+    if(params.velocity_version != velocity_version){
+        velocity_pid.setConfig(params.velocity_pid);
+        velocity_version = params.velocity_version;
+    }
+}
+
+void Mechanism::begin(){
+    Params params = this->params.read();
+    this->applyPID(params);
+    move.max_speed = fabs(move.max_speed); // make sure max_speed is a scalar
+    move.requested = unpackTarget(move.target);
+    move.setpoint = this->limitTarget(move.requested, params);
+    move.limits_version = params.limits_version;
+    move.error = 999;
+    move.ramp = 0;
+    move.calculated_speed = 999;
+    move.final_speed = 0;
+
+    move.cascaded = params.cascaded;
+    if(move.cascaded && params.velocity_pid.delay_time > params.pid.delay_time)
+        LOG(WARN) << "#" << mech_id << "'s velocity loop is slower than its position loop";
+    move.period = periodOf(params, false, move.outer_ticks);
+    move.countdown = 0;
+    move.commanded = false;
+    move.start = this->getPosition(deg);
+    move.start_time = vex::timer::system();
+
+    // readers see the new move straight away, the rest is filled in every tick
+    move.published.target = move.setpoint;
+    move.published.phase = MoveStatus::RUNNING;
+    move.published.move = move.ticking;
+    this->state.publish(move.published);
+
+    LOG(DEBUG) << "moving #" << mech_id << " to " << move.setpoint << " with max speed " << move.max_speed;
+    if(params.stall_version != stall_version){
+        stall = params.stall_enabled ? StallDetector(params.stall_window, params.stall_min_progress, params.stall_min_current) : StallDetector();
+        stall_version = params.stall_version;
+    }
+    stall.reset();
+
+    // continue from the speed a chained or preempted move left the motors at if it is in the right direction
+    if(carry_speed != 0 && std::signbit(carry_speed) == std::signbit(move.setpoint - this->getPosition(deg))){
+        move.ramp = carry_speed;
+    }
+}
+
+bool Mechanism::tick(void* args){
+    Mechanism* mech = (Mechanism*)args;
+    Move& move = mech->move;
+    if(move.cancelled == move.ticking) {mech->finish(MoveStatus::CANCELLED); return false;}
+
+    // pick up parameters changed by another task
+    Params params = mech->params.read();
+    mech->applyPID(params);
+
+    MotorBus::Sample sample = MotorBus::instance().getSample(mech->channel);
+    float state = sample.position * mech->gear_ratio; // get the state of the motors
+    float velocity = sample.velocity * mech->gear_ratio;
+
+    // progress triggers and exit conditions run every tick, measured along the move towards its target
+    if(!move.options.empty()){
+        float total = move.setpoint - move.start;
+        float travelled = total < 0 ? move.start - state : state - move.start;
+        if(move.options.update(travelled, std::fabs(total), vex::timer::system() - move.start_time)){
+            LOG(DEBUG) << "#" << mech->mech_id << " met an exit condition with " << move.error << " error";
+            move.options.cancelLinked();
+            mech->finish(MoveStatus::EXITED);
+            return false;
+        }
+    }
+
+    // the position loop runs every tick, or every few ticks of the velocity loop when cascaded
+    if(move.countdown == 0){
+        move.countdown = move.outer_ticks;
+
+        // pick up a new target from MoveHandle::retarget, or a new offset or bounds
+        // a target packed with a newer move's id belongs to the move taking over
+        uint64_t target = move.target;
+        bool retargeted = (uint32_t)(target >> 32) == move.ticking && unpackTarget(target) != move.requested;
+        if(retargeted || params.limits_version != move.limits_version){
+            if(retargeted) {move.requested = unpackTarget(target);}
+            move.limits_version = params.limits_version;
+            move.setpoint = mech->limitTarget(move.requested, params);
+            LOG(DEBUG) << "retargeting #" << mech->mech_id << " to " << move.setpoint;
+        }
+
+        float error = move.setpoint - state; // difference between target and state
+        move.error = error;
+
+        // hand off to the next move once within the exit error, but only after this move has
+        // commanded the motors, or they would keep running the previous move's command
+        if(move.exit_error >= 0 && fabs(error) <= move.exit_error && move.commanded){
+            mech->finish(MoveStatus::CHAINED);
+            return false;
+        }
+
+        // checks if the system has settled on this tick's error and measured speed, or timed out
+        float measured = sample.filtered_velocity * mech->gear_ratio * 6.0f; // rpm to degrees per second
+        if(!mech->pid.unfinished(error, move.calculated_speed, measured)){
+            mech->finish(mech->pid.timedOut() ? MoveStatus::TIMED_OUT : MoveStatus::SETTLED);
+            return false;
+        }
+
+        // log what the motors did this tick, from the same bus sample as the position
+        Telemetry telemetry = {velocity, sample.acceleration * mech->gear_ratio, sample.current, sample.temperature, sample.battery};
+
+        float max_speed = move.max_speed;
+        move.calculated_speed = mech->pid.calculateSpeed(error, max_speed, mech->mech_id, telemetry); // calculate PID speed
+
         //limit to ramp speed if ramp is less than max_speed
-        if(mech->max_acceleration > 0 && fabs(ramp) < max_speed){
-            final_speed = ramp;
-            ramp += error < 0 ? -mech->max_acceleration : mech->max_acceleration;
+        if(params.max_acceleration > 0 && fabs(move.ramp) < max_speed){
+            move.final_speed = move.ramp;
+            move.ramp += error < 0 ? -params.max_acceleration : params.max_acceleration;
         } else {
-            final_speed = calculated_speed;
+            move.final_speed = move.calculated_speed;
         }
 
-        mech->motors->spin(fwd, final_speed, pct); // spin the motors at speed
-        this_thread::sleep_for(mech->pid.getDelayTime()); // delay by pid.delay_time milliseconds
+        // end early if the mechanism is pushing against something it can't move
+        StallDetector::Reading reading = {vex::timer::system(), state, velocity, sample.current, (float)move.final_speed};
+        if(mech->stall.update(reading)){
+            LOG(WARN) << "#" << mech->mech_id << " stalled with " << move.error << " error";
+            mech->finish(params.stall_action == StallAction::COMPLETE ? MoveStatus::SETTLED : MoveStatus::STALLED);
+            return false;
+        }
+    }
+    move.countdown--;
+
+    float output = move.final_speed;
+    if(move.cascaded){
+        // the position loop's speed is a velocity setpoint, fed forward and corrected with measured velocity
+        float setpoint = move.final_speed / 100.0 * params.max_velocity;
+        output += mech->velocity_pid.calculateSpeed(setpoint - velocity, 100, mech->velocity_id);
+        output = fmax(fmin(output, 100), -100);
+    }
+
+    mech->output(output, params); // spin the motors at speed on the next flush
+    move.commanded = true;
+    move.published.position = state;
+    move.published.target = move.setpoint;
+    move.published.error = move.error;
+    move.published.output = output;
+    move.published.time = vex::timer::system();
+    mech->state.publish(move.published);
+    return true;
+}
+
+bool Mechanism::velocityTick(void* args){
+    Mechanism* mech = (Mechanism*)args;
+    Move& move = mech->move;
+    if(move.cancelled == move.ticking) {mech->finish(MoveStatus::CANCELLED); return false;}
+
+    Params params = mech->params.read();
+
+    // velocity from the encoder deltas of the bus samples, filtered
+    MotorBus::Sample sample = MotorBus::instance().getSample(mech->channel);
+    float position = sample.position * mech->gear_ratio;
+    float velocity = mech->velocity.estimate(position, sample.time, sample.velocity * mech->gear_ratio);
+
+    uint64_t packed = move.target;
+    if((uint32_t)(packed >> 32) == move.ticking) {move.requested = unpackTarget(packed);}
+    float target = move.requested;
+    uint32_t now = vex::timer::system();
+    float output = mech->velocity.update(target, velocity, now, mech->mech_id);
+    move.error = target - velocity;
+    move.final_speed = output;
+
+    mech->output(output, params); // spin the motors at speed on the next flush
+    mech->velocity_metrics.publish(mech->velocity.getMetrics());
+    move.published.position = position;
+    move.published.target = target;
+    move.published.error = move.error;
+    move.published.output = output;
+    move.published.time = now;
+    mech->state.publish(move.published);
+    return true;
+}
+
+void Mechanism::finish(MoveStatus result){
+    if(result == MoveStatus::CHAINED || result == MoveStatus::PREEMPTED){
+        // leave the motors running for the next move
+        LOG(DEBUG) << "Handing off #" << mech_id << " with " << move.error << " error";
+        chained = result == MoveStatus::CHAINED;
+        chain_target = move.requested;
+        carry_speed = move.final_speed;
+    } else {
+        LOG(DEBUG) << "Stopping #" << mech_id << " with " << move.error << " error";
+        this->halt();
     }
+    pid.reset();
+    if(move.cascaded) {velocity_pid.reset();}
+    if(move.velocity_mode) {velocity.finish();}
+    move.published.phase = result;
+    move.published.time = vex::timer::system();
+    this->state.publish(move.published);
+    move.running = false;
+    history[move.ticking % HISTORY] = result;
+}
+
+uint64_t Mechanism::packTarget(uint32_t id, float target){
+    uint32_t bits;
+    memcpy(&bits, &target, sizeof(bits));
+    return ((uint64_t)id << 32) | bits;
+}
+
+float Mechanism::unpackTarget(uint64_t packed){
+    uint32_t bits = (uint32_t)packed;
+    float target;
+    memcpy(&target, &bits, sizeof(target));
+    return target;
+}
 
-    LOG(DEBUG) << "Stopping " << mech->mech_id << " with " << error << " error";
-    mech->stop();
-    mech->pid.reset();
-    return;
+MechanismState Mechanism::getState() const{
+    return state.read();
 }
 
 float Mechanism::getPosition(rotationUnits units){
-    return motors->position(units) * gear_ratio;
+    switch(units){
+        case rotationUnits::deg: return MotorBus::instance().getSample(channel).position * gear_ratio;
+        case rotationUnits::rev: return MotorBus::instance().getSample(channel).position / 360.0 * gear_ratio;
+        default: return motors->position(units) * gear_ratio;
+    }
+}
+
+float Mechanism::getVelocity(velocityUnits units){
+    switch(units){
+        case velocityUnits::rpm: return MotorBus::instance().getSample(channel).velocity * gear_ratio;
+        case velocityUnits::dps: return MotorBus::instance().getSample(channel).velocity * 6.0 * gear_ratio;
+        default: return motors->velocity(units) * gear_ratio;
+    }
+}
+
+float Mechanism::getFilteredVelocity(){
+    return MotorBus::instance().getSample(channel).filtered_velocity * gear_ratio;
+}
+
+float Mechanism::getAcceleration(){
+    return MotorBus::instance().getSample(channel).acceleration * gear_ratio;
+}
+
+void Mechanism::setEstimator(const StateEstimator& estimator){
+    MotorBus::instance().setEstimator(channel, estimator);
+}
+
+float Mechanism::getCurrent(){
+    return MotorBus::instance().getSample(channel).current;
 }
 
 void Mechanism::resetPosition(){
     motors->resetPosition();
+    MotorBus::instance().invalidate(channel);
 }
 
 void Mechanism::setBrakeType(brakeType type){
@@ -115,20 +633,112 @@ void Mechanism::setBrakeType(brakeType type){
 }
 
 void Mechanism::setPID(PID pid){
-    this->pid = pid;
+    const PIDConfig& config = pid.getConfig();
+    this->params.update([&config](Params& p){
+        p.pid = config;
+        p.pid_version++;
+    });
+}
+
+void Mechanism::setCascade(PID velocity_pid, float max_velocity){
+    if(max_velocity <= 0)
+        LOG(WARN) << "Cascade max velocity must be positive";
+    if(velocity_id == -1)
+        velocity_id = Registry::intern(Registry::name(mech_id) + "_VELOCITY");
+    const PIDConfig& config = velocity_pid.getConfig();
+    this->params.update([&config, max_velocity](Params& p){
+        p.velocity_pid = config;
+        p.velocity_version++;
+        p.max_velocity = max_velocity;
+        p.cascaded = true;
+    });
+}
+
+void Mechanism::disableCascade(){
+    this->params.update([](Params& p){p.cascaded = false;});
 }
 
 void Mechanism::setOffset(float offset){
-    this->offset = offset;
+    this->params.update([offset](Params& p){
+        p.offset = offset;
+        p.limits_version++;
+    });
 }
 
 void Mechanism::setMaxAcceleration(float max_accel){
-    this->max_acceleration = max_accel;
+    this->params.update([max_accel](Params& p){p.max_acceleration = max_accel;});
+}
+
+void Mechanism::setVoltageCompensation(float nominal){
+    if(nominal < 0)
+        LOG(WARN) << "Negative nominal voltage not allowed";
+    this->params.update([nominal](Params& p){p.nominal_voltage = nominal;});
+}
+
+void Mechanism::setThermalLimit(float start, float limit, float min_scale, float max_current){
+    if(start <= 0 || limit < start)
+        LOG(WARN) << "Thermal limit must be above a positive start temperature";
+    if(min_scale <= 0 || min_scale > 1)
+        LOG(WARN) << "Thermal minimum scale must be between 0 and 1";
+    min_scale = fmin(fmax(min_scale, 0.05), 1);
+    this->params.update([start, limit, min_scale, max_current](Params& p){
+        p.thermal_start = start;
+        p.thermal_limit = limit;
+        p.thermal_min_scale = min_scale;
+        p.max_current = max_current;
+        p.thermal_version++;
+    });
+    // the next output resets the scale, this sets the limit of a mechanism that isn't moving
+    MotorBus::instance().setCurrentLimit(channel, max_current);
+}
+
+void Mechanism::disableThermalLimit(){
+    float max_current = 0;
+    this->params.update([&max_current](Params& p){
+        p.thermal_start = 0;
+        p.thermal_version++;
+        max_current = p.max_current;
+    });
+    MotorBus::instance().setCurrentLimit(channel, max_current);
+}
+
+float Mechanism::getThermalScale(){
+    return this->params.read().thermal_start > 0 ? thermal_scale.load() : 1;
+}
+
+void Mechanism::setStallDetection(int window, float min_progress, float min_current, StallAction action){
+    if(window <= 0 || min_progress < 0)
+        LOG(WARN) << "Stall window must be positive and progress non-negative";
+    // the detector keeps one reading per PID tick, so a longer window could never be covered
+    int period = this->params.read().pid.delay_time;
+    if(period > 0 && window > StallDetector::CAPACITY * period){
+        LOG(WARN) << "Stall window of " << window << " ms is longer than " << StallDetector::CAPACITY
+                  << " PID ticks, reduced to " << StallDetector::CAPACITY * period << " ms";
+        window = StallDetector::CAPACITY * period;
+    }
+    this->params.update([window, min_progress, min_current, action](Params& p){
+        p.stall_enabled = true;
+        p.stall_window = window;
+        p.stall_min_progress = min_progress;
+        p.stall_min_current = min_current;
+        p.stall_action = action;
+        p.stall_version++;
+    });
+}
+
+void Mechanism::disableStallDetection(){
+    this->params.update([](Params& p){
+        p.stall_enabled = false;
+        p.stall_version++;
+    });
 }
 
 void Mechanism::setBounds(float lower_bound, float upper_bound){
     if(lower_bound >= upper_bound)
         LOG(WARN) << "Bounds might be reversed. Double check.";
-    this->lower_bound = lower_bound;
-    this->upper_bound = upper_bound;
+    this->params.update([lower_bound, upper_bound](Params& p){
+        p.lower_bound = lower_bound;
+        p.upper_bound = upper_bound;
+        p.limits_version++;
+    });
 }
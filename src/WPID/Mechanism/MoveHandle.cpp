@@ -0,0 +1,32 @@
+#include "WPID/Mechanism/Mechanism.h"
+
+using namespace wpid;
+
+bool MoveHandle::active() const{
+    return this->status() == MoveStatus::RUNNING;
+}
+
+MoveStatus MoveHandle::status() const{
+    if(mech == nullptr || id == 0) {return MoveStatus::IDLE;}
+    uint32_t current = mech->move.id;
+    if(current - id < (uint32_t)Mechanism::HISTORY) {return mech->history[id % Mechanism::HISTORY];}
+    return MoveStatus::IDLE;
+}
+
+void MoveHandle::cancel(){
+    if(mech == nullptr || id == 0) {return;}
+    // only ever raise the cancelled id, so a handle to a finished move can't cancel the next
+    // move or undo a newer cancel, and the running move only stops if the id is its own
+    uint32_t cancelled = mech->move.cancelled;
+    while((int32_t)(id - cancelled) > 0 && !mech->move.cancelled.compare_exchange_weak(cancelled, id)) {}
+}
+
+bool MoveHandle::retarget(float position){
+    if(!this->active()) {return false;}
+    // swap the target only while it still belongs to this move, a new move packs its own id
+    uint64_t target = mech->move.target;
+    while((uint32_t)(target >> 32) == id){
+        if(mech->move.target.compare_exchange_weak(target, Mechanism::packTarget(id, position))) {return true;}
+    }
+    return false;
+}
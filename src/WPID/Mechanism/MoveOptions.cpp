@@ -0,0 +1,83 @@
+#include "WPID/Mechanism/MoveOptions.h"
+
+using namespace wpid;
+
+MoveOptions& MoveOptions::exitWhen(ExitCondition condition, void* data){
+    if(condition == nullptr) {return *this;}
+    if(condition_count == MAX_CONDITIONS){
+        LOG(WARN) << "A move can only have " << MAX_CONDITIONS << " exit conditions";
+        return *this;
+    }
+    conditions[condition_count++] = {condition, data};
+    return *this;
+}
+
+MoveOptions& MoveOptions::trigger(Progress progress, float at, Callback callback, void* data){
+    if(callback == nullptr) {return *this;}
+    if(trigger_count == MAX_TRIGGERS){
+        LOG(WARN) << "A move can only have " << MAX_TRIGGERS << " triggers";
+        return *this;
+    }
+    triggers[trigger_count++] = {progress, at, callback, data, false};
+    return *this;
+}
+
+MoveOptions& MoveOptions::atDistance(float distance, Callback callback, void* data){
+    return this->trigger(Progress::DISTANCE, std::fabs(distance), callback, data);
+}
+
+MoveOptions& MoveOptions::atFraction(float fraction, Callback callback, void* data){
+    return this->trigger(Progress::FRACTION, fraction, callback, data);
+}
+
+MoveOptions& MoveOptions::afterTime(int time, Callback callback, void* data){
+    return this->trigger(Progress::TIME, time, callback, data);
+}
+
+MoveOptions MoveOptions::scaled(float factor) const{
+    MoveOptions result = *this;
+    for(int i = 0; i < trigger_count; i++){
+        if(result.triggers[i].progress == Progress::DISTANCE) {result.triggers[i].at *= std::fabs(factor);}
+    }
+    return result;
+}
+
+MoveOptions& MoveOptions::cancelOnExit(const MoveHandle& move){
+    if(linked_count == MAX_LINKED){
+        LOG(WARN) << "A move can only cancel " << MAX_LINKED << " other moves";
+        return *this;
+    }
+    linked[linked_count++] = move;
+    return *this;
+}
+
+void MoveOptions::cancelLinked(){
+    for(int i = 0; i < linked_count; i++) {linked[i].cancel();}
+}
+
+bool MoveOptions::empty() const{
+    return condition_count == 0 && trigger_count == 0;
+}
+
+bool MoveOptions::update(float travelled, float total, uint32_t elapsed){
+    // a move that starts on its target is already complete
+    float fraction = total > 0 ? travelled / total : 1;
+    for(int i = 0; i < trigger_count; i++){
+        Trigger& t = triggers[i];
+        if(t.fired) {continue;}
+        bool reached = false;
+        switch(t.progress){
+            case Progress::DISTANCE: reached = travelled >= t.at; break;
+            case Progress::FRACTION: reached = fraction >= t.at; break;
+            case Progress::TIME:     reached = elapsed >= t.at; break;
+        }
+        if(reached){
+            t.fired = true;
+            t.callback(t.data);
+        }
+    }
+    for(int i = 0; i < condition_count; i++){
+        if(conditions[i].condition(conditions[i].data)) {return true;}
+    }
+    return false;
+}
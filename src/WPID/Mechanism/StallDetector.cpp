@@ -0,0 +1,22 @@
+#include "WPID/Mechanism/StallDetector.h"
+
+using namespace wpid;
+
+bool StallDetector::update(const Reading& reading){
+    if(!enabled) {return false;}
+    readings[head] = reading;
+    head = (head + 1) % CAPACITY;
+    if(count < CAPACITY) {count++;}
+
+    // walk back from the newest reading until the window is covered
+    const Reading& newest = reading;
+    for(int i = 0; i < count; i++){
+        const Reading& r = readings[(head - 1 - i + CAPACITY) % CAPACITY];
+        if(std::fabs(r.command) < min_command) {return false;}
+        if(std::fabs(r.velocity) > max_velocity) {return false;}
+        if(min_current >= 0 && r.current < min_current) {return false;}
+        if(std::fabs(newest.position - r.position) >= min_progress) {return false;}
+        if(newest.time - r.time >= (uint32_t)window) {return true;}
+    }
+    return false;
+}
@@ -0,0 +1,143 @@
+#include "WPID/Mechanism/VelocityController.h"
+
+using namespace wpid;
+
+VelocityController::VelocityController(const VelocityConfig& config) : config(config), pid(config.pid){}
+
+VelocityController VelocityController::feedforwardPID(float kv, float ks, PID pid){
+    VelocityConfig config;
+    config.strategy = VelocityStrategy::FEEDFORWARD_PID;
+    config.kv = kv;
+    config.ks = ks;
+    config.pid = pid.getConfig();
+    // a flywheel spins all match, so its ticks would crowd every other run out of the log
+    config.pid.logging = false;
+    config.period = pid.getDelayTime();
+    return VelocityController(config);
+}
+
+VelocityController VelocityController::takeBackHalf(float kv, float gain){
+    VelocityConfig config;
+    config.strategy = VelocityStrategy::TAKE_BACK_HALF;
+    config.kv = kv;
+    config.tbh_gain = gain;
+    return VelocityController(config);
+}
+
+VelocityController VelocityController::bangBang(float kv, float band){
+    VelocityConfig config;
+    config.strategy = VelocityStrategy::BANG_BANG;
+    config.kv = kv;
+    config.band = band;
+    return VelocityController(config);
+}
+
+void VelocityController::setFilter(float alpha){
+    if(alpha <= 0 || alpha > 1)
+        LOG(WARN) << "Velocity filter must be between 0 and 1";
+    config.alpha = fmin(fmax(alpha, 0.01), 1);
+}
+
+void VelocityController::setTolerance(float tolerance){
+    config.tolerance = fabs(tolerance);
+}
+
+void VelocityController::setLogging(bool enabled){
+    config.pid.logging = enabled;
+    pid.setLogging(enabled);
+}
+
+void VelocityController::setPeriod(int period){
+    if(period <= 0)
+        LOG(WARN) << "Velocity period must be positive";
+    config.period = period > 0 ? period : 5;
+}
+
+int VelocityController::getPeriod() const{
+    return config.period;
+}
+
+const VelocityConfig& VelocityController::getConfig() const{
+    return config;
+}
+
+void VelocityController::start(float target, uint32_t now){
+    // the first guess at the output, take back half halves back towards it
+    if(target != this->target){
+        tbh = config.kv * target;
+        last_error = target - filtered;
+        target_time = now;
+        reached = false;
+        drop_time = 0;
+        metrics.spin_up_time = 0;
+    }
+    this->target = target;
+    metrics.target = target;
+}
+
+float VelocityController::estimate(float position, uint64_t time, float measured){
+    if(last_time == 0){
+        filtered = measured;
+    } else if(time > last_time){
+        // degrees per microsecond to rpm
+        float velocity = (position - last_position) / (time - last_time) * 1e6f / 6.0f;
+        filtered = config.alpha * velocity + (1 - config.alpha) * filtered;
+    }
+    last_position = position;
+    last_time = time;
+    metrics.velocity = filtered;
+    return filtered;
+}
+
+float VelocityController::update(float target, float velocity, uint32_t now, int id){
+    if(target != this->target) {this->start(target, now);}
+    float error = target - velocity;
+    float direction = target < 0 ? -1 : 1;
+
+    switch(config.strategy){
+        case VelocityStrategy::FEEDFORWARD_PID:
+            output = config.kv * target + (target != 0 ? config.ks * direction : 0) + pid.calculateSpeed(error, 100, id);
+            break;
+        case VelocityStrategy::TAKE_BACK_HALF:
+            output += config.tbh_gain * error;
+            if(std::signbit(error) != std::signbit(last_error)){
+                output = (output + tbh) / 2;
+                tbh = output;
+            }
+            break;
+        case VelocityStrategy::BANG_BANG:
+            if(error * direction > config.band) {output = 100 * direction;}
+            else if(error * direction < -config.band) {output = 0;}
+            else {output = config.kv * target;}
+            break;
+    }
+    last_error = error;
+
+    // never drive against the target direction, a fast flywheel coasts down instead
+    output = direction > 0 ? fmin(fmax(output, 0), 100) : fmax(fmin(output, 0), -100);
+    if(target == 0) {output = 0;}
+
+    // spin-up is the first time the target is reached, recovery is every return after that
+    bool in_band = fabs(error) <= config.tolerance;
+    if(!reached && in_band){
+        reached = true;
+        metrics.spin_up_time = now - target_time;
+    } else if(reached && !in_band && drop_time == 0){
+        drop_time = now;
+    } else if(drop_time != 0 && in_band){
+        metrics.recovery_time = now - drop_time;
+        metrics.recoveries++;
+        drop_time = 0;
+    }
+    metrics.ready = in_band;
+    return output;
+}
+
+void VelocityController::finish(){
+    pid.reset();
+    last_time = 0;
+}
+
+const VelocityMetrics& VelocityController::getMetrics() const{
+    return metrics;
+}
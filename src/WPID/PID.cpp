@@ -4,8 +4,50 @@ using namespace std;
 using namespace vex;
 using namespace wpid;
 
-float PID::calculateSpeed(float error, float max_speed, std::string mech_id){
-    if (start_time == -1) {start_time = vex::timer::system();} // set the start time of a new PID run
+PID::PID(float kp, float ki, float kd){
+    PIDConfig config;
+    config.kp = kp;
+    config.ki = ki;
+    config.kd = kd;
+    this->config = std::make_shared<const PIDConfig>(config);
+}
+
+PID::PID(const PIDConfig& config) : config(std::make_shared<const PIDConfig>(config)){}
+
+PID::PID(std::shared_ptr<const PIDConfig> config) : config(config ? config : defaults()){}
+
+std::shared_ptr<const PIDConfig> PID::defaults(void){
+    static std::shared_ptr<const PIDConfig> config = std::make_shared<const PIDConfig>();
+    return config;
+}
+
+PIDConfig& PID::edit(void){
+    std::shared_ptr<PIDConfig> changed = std::make_shared<PIDConfig>(*config);
+    config = changed;
+    return *changed;
+}
+
+const PIDConfig& PID::getConfig(void) const{
+    return *config;
+}
+
+void PID::setConfig(const PIDConfig& config){
+    this->config = std::make_shared<const PIDConfig>(config);
+}
+
+float PID::calculateSpeed(float error, float max_speed, int mech_id){
+    return this->calculateSpeed(error, max_speed, mech_id, Telemetry());
+}
+
+float PID::calculateSpeed(float error, float max_speed, int mech_id, const Telemetry& telemetry){
+    // read the config and state once for the tick
+    const PIDConfig& c = *config;
+    const float kp = c.kp, ki = c.ki, kd = c.kd;
+    const int delay_time = c.delay_time, bias = c.bias, max_integral_speed = c.max_integral_speed;
+    float& prev_error = state.prev_error;
+    float& prev_integral = state.prev_integral;
+    float& previous_estimate = state.previous_estimate;
+    if (state.start_time == -1) {state.start_time = vex::timer::system();} // set the start time of a new PID run
     float a = .7; // alpha gain of low pass filter
 
     // summation of error over time
@@ -42,97 +84,99 @@ float PID::calculateSpeed(float error, float max_speed, std::string mech_id){
     
     LOG(INFO) << "err: " << error << " spd: " << speed << " P: " << error*kp << " I: " << integral*ki << " D: " << derivative*kd;
 
-    this->fileLogging(error, speed, (error*kp), integral, derivative, mech_id);
+    if(c.logging) {this->fileLogging(error, speed, (error*kp), integral, derivative, mech_id, telemetry);}
 
     return speed;
 }
 
 void PID::setErrorRange(float bound){
-    this->bound = bound;
+    this->edit().bound = bound;
 }
 
 void PID::setDelayTime(int delay){
-    this->delay_time = delay;
+    this->edit().delay_time = delay;
 }
 
 int PID::getDelayTime(){
-    return this->delay_time;
+    return config->delay_time;
 }
 
 void PID::setBias(int bias){
-    this->bias = bias;
+    this->edit().bias = bias;
 }
 
 void PID::setLowSpeedThreshold(int threshold){
-    this->low_speed_threshold = threshold;
+    this->edit().low_speed_threshold = threshold;
+}
+
+void PID::setSettleCriteria(float error, float velocity, int time){
+    PIDConfig& config = this->edit();
+    config.settle_error = error;
+    config.settle_velocity = std::fabs(velocity);
+    config.settle_time = time < 0 ? 0 : time;
 }
 
 void PID::setTimeout(int timeout){
-    this->timeout = timeout;
+    this->edit().timeout = timeout;
 }
 
 void PID::setMaxIntegral(int max_integral){
-    this->max_integral_speed = max_integral;
+    this->edit().max_integral_speed = max_integral;
 }
 
 bool PID::unfinished(float error, int speed){
-    bool timedout = vex::timer::system() >= (timeout + start_time);
-    if(timeout != -1 && timedout) {
+    if(this->timedOut()) {
         LOG(WARN) << "PID timed out. Remaining error is " << error;
         return false;
     }
-    bool high_speed = low_speed_threshold != -1 ? speed > low_speed_threshold : false;
-    bool outside_bounds = std::fabs(error) > bound;
+    bool high_speed = config->low_speed_threshold != -1 ? std::abs(speed) > config->low_speed_threshold : false;
+    bool outside_bounds = std::fabs(error) > config->bound;
     return outside_bounds || high_speed;
 }
 
+bool PID::unfinished(float error, float speed, float velocity){
+    if(config->settle_error < 0) {return this->unfinished(error, (int)speed);}
+    if(this->timedOut()) {
+        LOG(WARN) << "PID timed out. Remaining error is " << error;
+        return false;
+    }
+    // leaving the band starts the time in it over
+    if(std::fabs(error) > config->settle_error || std::fabs(velocity) > config->settle_velocity){
+        state.settle_start = -1;
+        return true;
+    }
+    int now = vex::timer::system();
+    if(state.settle_start == -1) {state.settle_start = now;}
+    return now - state.settle_start < config->settle_time;
+}
+
+bool PID::timedOut(void){
+    int timeout = config->timeout;
+    return timeout != -1 && state.start_time != -1 && (int)vex::timer::system() >= timeout + state.start_time;
+}
+
 void PID::reset(void){
-    prev_error = MAXFLOAT;
-    prev_integral = 0;
-    previous_estimate = 0;
-    start_time = -1;
-    timeout = -1;
+    state = PIDState();
 }
 
 PID PID::copy(void){
-    PID dupe = PID(this->kp, this->ki, this->kd);
-    dupe.setDelayTime(this->delay_time);
-    dupe.setErrorRange(this->bound);
-    dupe.setBias(this->bias);
-    dupe.setLowSpeedThreshold(this->low_speed_threshold);
-    dupe.setTimeout(this->timeout);
-    dupe.setMaxIntegral(this->max_integral_speed);
-    return dupe;
-}
-
-void PID::fileLogging(float error, float speed, float proportional, float integral, float derivative, std::string mech_id){
-    ofstream myfile;
-    string suffix = ".csv";
-    if(fName.compare("LoggedData") == 0){
-        std::ostringstream ss;
-        ss << (int)vex::timer::system();
-        fName += ss.str();
-        myfile.open(fName + suffix, std::ios::app);
-        myfile << "Time,Error,Speed,Proportional,Integral,Derivative,Name\n";
-        myfile.close();
-    }
-    myfile.open(fName + suffix, std::ios::app);
-    myfile << vex::timer::system();
-    myfile << ",";
-    myfile << round(error*100.0)/100.0;
-    myfile << ",";
-    myfile << round(speed*100.0)/100.0;
-    myfile << ",";
-    myfile << round(proportional*100.0)/100.0;
-    myfile << ",";
-    myfile << round(integral*100.0)/100.0;
-    myfile << ",";
-    myfile << round(derivative*100.0)/100.0;
-    myfile << ",";
-    myfile << mech_id;
-    myfile << '\n';
-    myfile.close();
-    if(!unfinished(error, speed)){
-        fName = "LoggedData";
-    }
-}
\ No newline at end of file
+    return PID(this->config);
+}
+
+void PID::setTelemetry(bool enabled){
+    this->edit().telemetry = enabled;
+}
+
+void PID::setLogging(bool enabled){
+    this->edit().logging = enabled;
+}
+
+bool PID::telemetryEnabled(void){
+    return config->telemetry;
+}
+
+void PID::fileLogging(float error, float speed, float proportional, float integral, float derivative, int mech_id, const Telemetry& telemetry){
+    PIDLogger::Record record = {vex::timer::system(), (uint32_t)state.start_time, mech_id, error, speed,
+                                proportional, integral, derivative, config->telemetry, telemetry};
+    PIDLogger::instance().record(record);
+}
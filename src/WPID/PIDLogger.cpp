@@ -0,0 +1,120 @@
+#include "WPID/PIDLogger.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+using namespace vex;
+using namespace wpid;
+
+/**
+* Base name of the logging files
+*/
+static const char* LOG_FILE = "LoggedData";
+
+PIDLogger PIDLogger::logger;
+
+PIDLogger::PIDLogger(){
+    for(uint32_t i = 0; i < CAPACITY; i++){
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+PIDLogger& PIDLogger::instance(){
+    return logger;
+}
+
+bool PIDLogger::record(const Record& record){
+    // claim the next free slot, or give up if the writer hasn't freed it yet
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    while(true){
+        slot = &slots[position & (CAPACITY - 1)];
+        int32_t turn = (int32_t)(slot->sequence.load(std::memory_order_acquire) - position);
+        if(turn == 0){
+            if(tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {break;}
+        } else if(turn < 0){
+            dropped++;
+            return false;
+        } else {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = record;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void PIDLogger::start(){
+    // below the priority of every control loop
+    if(started.exchange(true)) {return;}
+    vex::thread* task = new vex::thread(writer);
+    task->setPriority(vex::thread::threadPriorityLow);
+}
+
+uint32_t PIDLogger::getDropped() const{
+    return dropped;
+}
+
+int PIDLogger::writer(void){
+    PIDLogger& log = PIDLogger::instance();
+    std::vector<uint32_t> headed; // runs whose file already has a header
+    ofstream file;
+    uint32_t open_run = 0;
+    uint32_t reported = 0;
+    while(true){
+        Slot& slot = log.slots[log.head & (CAPACITY - 1)];
+        if(slot.sequence.load(std::memory_order_acquire) != log.head + 1){
+            // caught up, so save what was written and wait for the next chunk
+            if(file.is_open()) {file.close();}
+            uint32_t dropped = log.dropped;
+            if(dropped != reported){
+                LOG(WARN) << "PID log fell behind, " << dropped - reported << " ticks were not saved";
+                reported = dropped;
+            }
+            this_thread::sleep_for(50);
+            continue;
+        }
+        Record r = slot.record;
+        slot.sequence.store(log.head + CAPACITY, std::memory_order_release);
+        log.head++;
+
+        // every run that starts in the same millisecond shares a file, as the name column tells them apart
+        if(!file.is_open() || r.run != open_run){
+            if(file.is_open()) {file.close();}
+            std::ostringstream ss;
+            ss << LOG_FILE << r.run << ".csv";
+            file.open(ss.str(), std::ios::app);
+            open_run = r.run;
+            bool new_run = true;
+            for(size_t i = 0; i < headed.size(); i++){
+                if(headed[i] == r.run) {new_run = false; break;}
+            }
+            if(new_run){
+                // only runs still going can come back, so the oldest are forgotten
+                if(headed.size() >= 32) {headed.erase(headed.begin());}
+                headed.push_back(r.run);
+                file << "Time,Error,Speed,Proportional,Integral,Derivative,";
+                if(r.has_telemetry) {file << "Velocity,Acceleration,Current,Temperature,Battery,";}
+                file << "Name\n";
+            }
+        }
+
+        file << r.time << ",";
+        file << round(r.error*100.0)/100.0 << ",";
+        file << round(r.speed*100.0)/100.0 << ",";
+        file << round(r.proportional*100.0)/100.0 << ",";
+        file << round(r.integral*100.0)/100.0 << ",";
+        file << round(r.derivative*100.0)/100.0 << ",";
+        if(r.has_telemetry){
+            file << round(r.telemetry.velocity*100.0)/100.0 << ",";
+            file << round(r.telemetry.acceleration*100.0)/100.0 << ",";
+            file << round(r.telemetry.current*100.0)/100.0 << ",";
+            file << round(r.telemetry.temperature*100.0)/100.0 << ",";
+            file << round(r.telemetry.battery*100.0)/100.0 << ",";
+        }
+        file << Registry::name(r.log_id) << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "WPID/Path/Path.h"
+
+using namespace wpid;
+
+Path::Path(std::vector<Point> waypoints, float resolution){
+    if(resolution <= 0){
+        LOG(WARN) << "Path resolution must be positive, using 1 inch";
+        resolution = 1.0;
+    }
+    this->resolution = resolution;
+
+    if(waypoints.size() < 2){
+        LOG(WARN) << "A path needs at least two waypoints";
+        if(waypoints.size() == 1)
+            samples.push_back({waypoints[0].x, waypoints[0].y, 1.0});
+        return;
+    }
+
+    // evaluate a Catmull-Rom spline through the waypoints into a dense polyline
+    const int steps = 16; // polyline points per waypoint segment
+    std::vector<Point> dense;
+    dense.reserve((waypoints.size() - 1) * steps + 1);
+    for(size_t i = 0; i + 1 < waypoints.size(); i++){
+        Point p0 = waypoints[i == 0 ? 0 : i - 1];
+        Point p1 = waypoints[i];
+        Point p2 = waypoints[i + 1];
+        Point p3 = waypoints[i + 2 < waypoints.size() ? i + 2 : i + 1];
+        for(int j = 0; j < steps; j++){
+            float t = (float)j / steps;
+            float t2 = t * t;
+            float t3 = t2 * t;
+            dense.push_back({
+                0.5f * (2*p1.x + (-p0.x + p2.x)*t + (2*p0.x - 5*p1.x + 4*p2.x - p3.x)*t2 + (-p0.x + 3*p1.x - 3*p2.x + p3.x)*t3),
+                0.5f * (2*p1.y + (-p0.y + p2.y)*t + (2*p0.y - 5*p1.y + 4*p2.y - p3.y)*t2 + (-p0.y + 3*p1.y - 3*p2.y + p3.y)*t3)
+            });
+        }
+    }
+    dense.push_back(waypoints.back());
+
+    this->resample(dense);
+}
+
+Path::Path(std::vector<PathPoint> samples, float resolution, float length){
+    if(samples.empty())
+        LOG(WARN) << "Path was created without any samples";
+    this->samples.swap(samples);
+    this->resolution = resolution;
+    this->total_length = length;
+}
+
+void Path::resample(const std::vector<Point>& dense){
+    samples.clear();
+    samples.push_back({dense[0].x, dense[0].y, 1.0});
+    total_length = 0;
+    float next = resolution; // arc length of the next sample to place
+
+    for(size_t i = 1; i < dense.size(); i++){
+        float dx = dense[i].x - dense[i-1].x;
+        float dy = dense[i].y - dense[i-1].y;
+        float segment = std::sqrt(dx*dx + dy*dy);
+        // place every sample that falls within this segment
+        while(segment > 0 && total_length + segment >= next){
+            float t = (next - total_length) / segment;
+            samples.push_back({dense[i-1].x + dx*t, dense[i-1].y + dy*t, 1.0});
+            next += resolution;
+        }
+        total_length += segment;
+    }
+
+    // the final sample is always the end of the path
+    const Point& end = dense.back();
+    const PathPoint& last = samples.back();
+    if(last.x != end.x || last.y != end.y){
+        samples.push_back({end.x, end.y, 1.0});
+    }
+}
+
+int Path::size() const{
+    return samples.size();
+}
+
+float Path::length() const{
+    return total_length;
+}
+
+float Path::getResolution() const{
+    return resolution;
+}
+
+const PathPoint& Path::at(int index) const{
+    static const PathPoint none = {0, 0, 0};
+    if(samples.empty()) {return none;}
+    if(index < 0) {index = 0;}
+    if(index >= (int)samples.size()) {index = samples.size() - 1;}
+    return samples[index];
+}
+
+int Path::indexAt(float distance) const{
+    int index = (int)(distance / resolution + 0.5f);
+    if(index < 0) {index = 0;}
+    if(index >= (int)samples.size()) {index = samples.size() - 1;}
+    return index;
+}
+
+float Path::distanceAt(int index) const{
+    if(index >= (int)samples.size() - 1) {return total_length;}
+    if(index < 0) {return 0;}
+    return index * resolution;
+}
+
+int Path::closestIndex(Point point, int start_index, int window) const{
+    if(samples.empty()) {return 0;}
+    int last = samples.size() - 1;
+    if(start_index < 0) {start_index = 0;}
+    if(start_index > last) {return last;}
+    int end = start_index + window < last ? start_index + window : last;
+
+    int best = start_index;
+    float best_distance = MAXFLOAT;
+    for(int i = start_index; i <= end; i++){
+        float dx = samples[i].x - point.x;
+        float dy = samples[i].y - point.y;
+        float distance = dx*dx + dy*dy;
+        if(distance < best_distance){
+            best_distance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
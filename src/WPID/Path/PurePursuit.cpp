@@ -0,0 +1,64 @@
+#include "WPID/Path/PurePursuit.h"
+
+using namespace wpid;
+
+PurePursuit::PurePursuit(const Path* path, float lookahead){
+    if(lookahead <= 0)
+        LOG(WARN) << "Lookahead distance must be positive";
+    this->path = path;
+    this->lookahead = lookahead;
+    this->lookahead_samples = (int)(lookahead / path->getResolution() + 0.5f);
+    if(lookahead_samples < 1) {lookahead_samples = 1;}
+}
+
+void PurePursuit::update(float forward, float lateral, float rotation){
+    // integrate along the average heading of the step
+    float heading = pose.heading + rotation/2;
+    float s = std::sin(heading);
+    float c = std::cos(heading);
+    pose.x += forward*s + lateral*c;
+    pose.y += forward*c - lateral*s;
+    pose.heading += rotation;
+
+    // the robot cannot move more than a lookahead per tick, so this window bounds the search
+    closest = path->closestIndex({pose.x, pose.y}, closest, lookahead_samples);
+}
+
+const Pose& PurePursuit::getPose() const{
+    return pose;
+}
+
+int PurePursuit::getClosestIndex() const{
+    return closest;
+}
+
+Point PurePursuit::lookaheadLocal() const{
+    const PathPoint& target = path->at(closest + lookahead_samples);
+    float dx = target.x - pose.x;
+    float dy = target.y - pose.y;
+    float s = std::sin(pose.heading);
+    float c = std::cos(pose.heading);
+    return {dx*c - dy*s, dx*s + dy*c};
+}
+
+float PurePursuit::curvature() const{
+    Point local = this->lookaheadLocal();
+    float distance_sq = local.x*local.x + local.y*local.y;
+    if(distance_sq < 1e-6) {return 0;}
+    return 2*local.x / distance_sq;
+}
+
+float PurePursuit::remaining() const{
+    int last = path->size() - 1;
+    if(closest < last){
+        return path->length() - path->distanceAt(closest);
+    }
+    // at the final sample, project the distance to the end onto the path's final direction
+    const PathPoint& end = path->at(last);
+    const PathPoint& before = path->at(last - 1);
+    float tx = end.x - before.x;
+    float ty = end.y - before.y;
+    float norm = std::sqrt(tx*tx + ty*ty);
+    if(norm < 1e-6) {return 0;}
+    return ((end.x - pose.x)*tx + (end.y - pose.y)*ty) / norm;
+}
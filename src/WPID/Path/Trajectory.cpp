@@ -0,0 +1,92 @@
+#include "WPID/Path/Trajectory.h"
+
+using namespace wpid;
+
+bool Trajectory::load(const char* filename){
+    paths.clear();
+    FILE* file = fopen(filename, "rb");
+    if(file == NULL){
+        LOG(WARN) << "Could not open trajectory file " << filename;
+        return false;
+    }
+
+    // the file size bounds every sample count, so a corrupt count can't ask for a huge allocation
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if(fread(&header, sizeof(TrajectoryHeader), 1, file) != 1
+    || header.magic[0] != 'W' || header.magic[1] != 'P' || header.magic[2] != 'T' || header.magic[3] != 'J'){
+        LOG(WARN) << filename << " is not a trajectory file";
+        fclose(file);
+        return false;
+    }
+    if(header.version != VERSION){
+        LOG(WARN) << filename << " is version " << header.version << ", expected version " << (int)VERSION;
+        fclose(file);
+        return false;
+    }
+
+    paths.reserve(header.path_count);
+    for(int i = 0; i < header.path_count; i++){
+        TrajectoryPathHeader path_header;
+        if(fread(&path_header, sizeof(TrajectoryPathHeader), 1, file) != 1){
+            LOG(WARN) << filename << " ended before path " << i;
+            fclose(file);
+            return false;
+        }
+        long remaining = file_size - ftell(file);
+        if(remaining < 0 || path_header.sample_count > (unsigned long)remaining / sizeof(PathPoint)){
+            LOG(WARN) << filename << " has more samples in path " << i << " than the file holds";
+            fclose(file);
+            return false;
+        }
+        // samples are stored exactly as PathPoint, so they are read straight into the lookup table
+        std::vector<PathPoint> samples(path_header.sample_count);
+        if(fread(samples.data(), sizeof(PathPoint), path_header.sample_count, file) != path_header.sample_count){
+            LOG(WARN) << filename << " ended in the middle of path " << i;
+            fclose(file);
+            return false;
+        }
+        paths.push_back(Path(std::move(samples), path_header.resolution, path_header.length));
+    }
+    fclose(file);
+
+    LOG(INFO) << "Loaded " << paths.size() << " paths from " << filename;
+    return true;
+}
+
+int Trajectory::size() const{
+    return paths.size();
+}
+
+const Path& Trajectory::getPath(int index) const{
+    if(index < 0 || index >= (int)paths.size()){
+        LOG(WARN) << "Trajectory has no path " << index;
+        static const Path empty = Path();
+        return empty;
+    }
+    return paths[index];
+}
+
+bool Trajectory::checkChassis(float track_width, float wheel_radius, float center_wheel_radius, float drive_gear_ratio) const{
+    const float tolerance = 0.001;
+    bool matches = true;
+    if(std::fabs(header.track_width - track_width) > tolerance){
+        LOG(WARN) << "Trajectory was compiled for track width " << header.track_width;
+        matches = false;
+    }
+    if(std::fabs(header.wheel_radius - wheel_radius) > tolerance){
+        LOG(WARN) << "Trajectory was compiled for wheel radius " << header.wheel_radius;
+        matches = false;
+    }
+    if(std::fabs(header.center_wheel_radius - center_wheel_radius) > tolerance){
+        LOG(WARN) << "Trajectory was compiled for center wheel radius " << header.center_wheel_radius;
+        matches = false;
+    }
+    if(std::fabs(header.drive_gear_ratio - drive_gear_ratio) > tolerance){
+        LOG(WARN) << "Trajectory was compiled for drive gear ratio " << header.drive_gear_ratio;
+        matches = false;
+    }
+    return matches;
+}
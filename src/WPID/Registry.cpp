@@ -0,0 +1,41 @@
+#include "WPID/Registry.h"
+#include "WPID/Logger.h"
+
+using namespace wpid;
+
+std::deque<std::string>& Registry::names(){
+    static std::deque<std::string> names;
+    return names;
+}
+
+vex::mutex& Registry::lock(){
+    static vex::mutex lock;
+    return lock;
+}
+
+int Registry::intern(const std::string& name){
+    lock().lock();
+    std::deque<std::string>& list = names();
+    int id = -1;
+    for(size_t i = 0; i < list.size(); i++){
+        if(list[i] == name) {id = i; break;}
+    }
+    bool added = id == -1;
+    if(added){
+        list.push_back(name);
+        id = list.size() - 1;
+    }
+    lock().unlock();
+    // control loops log the id rather than look up the name, so this is how to read their lines
+    if(added) {LOG(INFO) << "#" << id << " is " << name;}
+    return id;
+}
+
+const std::string& Registry::name(int id){
+    static const std::string unknown = "UNKNOWN";
+    lock().lock();
+    std::deque<std::string>& list = names();
+    const std::string& result = id >= 0 && id < (int)list.size() ? list[id] : unknown;
+    lock().unlock();
+    return result;
+}
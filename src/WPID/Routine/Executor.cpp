@@ -0,0 +1,49 @@
+#include "WPID/Routine/Executor.h"
+
+using namespace vex;
+using namespace wpid;
+
+int Executor::add(const Routine& routine){
+    routines.push_back(routine);
+    return routines.size() - 1;
+}
+
+void Executor::tick(){
+    uint32_t now = vex::timer::system();
+    tick_count++;
+    for(size_t i = 0; i < routines.size(); i++){
+        routines[i].tick(now);
+    }
+}
+
+void Executor::run(int period){
+    while(!this->done()){
+        this->tick();
+        this_thread::sleep_for(period);
+    }
+}
+
+bool Executor::done() const{
+    for(size_t i = 0; i < routines.size(); i++){
+        if(!routines[i].done()) {return false;}
+    }
+    return true;
+}
+
+void Executor::cancel(int index){
+    if(index < 0 || index >= (int)routines.size()){
+        LOG(WARN) << "Executor has no routine " << index;
+        return;
+    }
+    routines[index].cancel();
+}
+
+void Executor::cancelAll(){
+    for(size_t i = 0; i < routines.size(); i++){
+        routines[i].cancel();
+    }
+}
+
+uint32_t Executor::getTickCount() const{
+    return tick_count;
+}
@@ -0,0 +1,77 @@
+#include "WPID/Routine/Routine.h"
+
+using namespace wpid;
+
+Routine& Routine::then(std::function<Completion()> motion){
+    Step step = {Step::MOTION, motion, nullptr, nullptr, 0};
+    steps.push_back(step);
+    return *this;
+}
+
+Routine& Routine::wait(int duration){
+    Step step = {Step::WAIT, nullptr, nullptr, nullptr, duration};
+    steps.push_back(step);
+    return *this;
+}
+
+Routine& Routine::until(std::function<bool()> condition){
+    Step step = {Step::UNTIL, nullptr, condition, nullptr, 0};
+    steps.push_back(step);
+    return *this;
+}
+
+Routine& Routine::call(std::function<void()> action){
+    Step step = {Step::CALL, nullptr, nullptr, action, 0};
+    steps.push_back(step);
+    return *this;
+}
+
+bool Routine::stepFinished(uint32_t now){
+    if(current < 0) {return true;}
+    const Step& step = steps[current];
+    switch(step.type){
+        case Step::MOTION: return running.done();
+        case Step::WAIT:   return now - step_start >= (uint32_t)step.duration;
+        case Step::UNTIL:  return step.condition();
+        default:           return true;
+    }
+}
+
+void Routine::startStep(uint32_t now){
+    Step& step = steps[current];
+    step_start = now;
+    running = Completion();
+    LOG(DEBUG) << name << " starting step " << current;
+    switch(step.type){
+        case Step::MOTION: running = step.motion(); break;
+        case Step::CALL:   step.action(); break;
+        default: break;
+    }
+}
+
+bool Routine::tick(uint32_t now){
+    // start every step that is ready, so instant steps don't cost a tick each
+    while(!this->done() && this->stepFinished(now)){
+        current++;
+        if(this->done()) {
+            LOG(DEBUG) << name << " finished";
+            break;
+        }
+        this->startStep(now);
+    }
+    return !this->done();
+}
+
+bool Routine::done() const{
+    return current >= (int)steps.size();
+}
+
+void Routine::cancel(){
+    running.cancel();
+    current = steps.size();
+}
+
+void Routine::reset(){
+    running = Completion();
+    current = -1;
+}
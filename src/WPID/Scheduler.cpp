@@ -0,0 +1,110 @@
+#include "WPID/Scheduler.h"
+
+using namespace vex;
+using namespace wpid;
+
+Scheduler& Scheduler::instance(){
+    static Scheduler scheduler;
+    return scheduler;
+}
+
+Scheduler::Group* Scheduler::group(int period){
+    for(size_t i = 0; i < groups.size(); i++){
+        if(groups[i]->period == period) {return groups[i];}
+    }
+    if(groups.empty()) {epoch = timer::system();}
+
+    Group* g = new Group();
+    g->period = period;
+    // stagger the groups a millisecond apart within the shortest period
+    g->phase = groups.size() % period;
+    g->ticks = 0;
+    g->overruns = 0;
+    groups.push_back(g);
+
+    g->worker = new thread(run, (void*)g);
+    // shorter periods preempt longer ones
+    int priority = thread::threadPriorityNormal;
+    if(period <= 5) {priority += 3;}
+    else if(period <= 10) {priority += 2;}
+    else if(period <= 20) {priority += 1;}
+    g->worker->setPriority(priority);
+    LOG(DEBUG) << "Started " << period << " ms rate group at phase " << g->phase;
+    return g;
+}
+
+int Scheduler::run(void* data){
+    Scheduler& scheduler = Scheduler::instance();
+    Group* g = (Group*)data;
+    // the first slot on the group's phase grid that hasn't passed yet
+    uint32_t next = scheduler.epoch + g->phase;
+    uint32_t start = timer::system();
+    if(start > next) {next += ((start - next) / g->period + 1) * g->period;}
+    Job jobs[MAX_JOBS];
+    while(true){
+        uint32_t now = timer::system();
+        if(next > now) {this_thread::sleep_for(next - now);}
+
+        // run a copy so tasks can add and remove jobs while the group runs
+        scheduler.lock.lock();
+        for(int i = 0; i < MAX_JOBS; i++) {jobs[i] = g->jobs[i];}
+        scheduler.lock.unlock();
+
+        for(int i = 0; i < MAX_JOBS; i++){
+            if(jobs[i].id == 0 || jobs[i].task(jobs[i].data)) {continue;}
+            scheduler.lock.lock();
+            if(g->jobs[i].id == jobs[i].id) {g->jobs[i].id = 0;}
+            scheduler.lock.unlock();
+        }
+        g->ticks++;
+
+        // keep to the phase grid, skipping any slots that were missed
+        next += g->period;
+        now = timer::system();
+        if(now >= next){
+            uint32_t missed = (now - next) / g->period + 1;
+            g->overruns += missed;
+            next += missed * g->period;
+        }
+    }
+    return 0;
+}
+
+int Scheduler::add(int period, Task task, void* data){
+    if(period <= 0){
+        LOG(WARN) << "Scheduler periods must be positive";
+        period = 1;
+    }
+    lock.lock();
+    Group* g = this->group(period);
+    int id = -1;
+    for(int i = 0; i < MAX_JOBS; i++){
+        if(g->jobs[i].id != 0) {continue;}
+        id = ++last_id;
+        g->jobs[i] = {id, task, data};
+        break;
+    }
+    lock.unlock();
+    if(id == -1)
+        LOG(WARN) << "The " << period << " ms rate group is full";
+    return id;
+}
+
+void Scheduler::remove(int job){
+    if(job <= 0) {return;}
+    lock.lock();
+    for(size_t g = 0; g < groups.size(); g++){
+        for(int i = 0; i < MAX_JOBS; i++){
+            if(groups[g]->jobs[i].id == job) {groups[g]->jobs[i].id = 0;}
+        }
+    }
+    lock.unlock();
+}
+
+uint32_t Scheduler::getOverruns(){
+    uint32_t total = 0;
+    lock.lock();
+    for(size_t g = 0; g < groups.size(); g++) {total += groups[g]->overruns;}
+    lock.unlock();
+    return total;
+}
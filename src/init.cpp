@@ -5,6 +5,7 @@ controller* con = new controller(controllerType::primary);
 
 HDrive* chassis;
 //Mechanism* fourbar;
+Trajectory routine;
 
 motor leftFront = motor(PORT17, ratio18_1, false);
 motor leftBack = motor(PORT18, ratio18_1, false);
@@ -22,7 +23,12 @@ motor_group centerGroup = motor_group(center);
 
 void init(void) {
     Brain.Screen.clearScreen();
-    chassis = new HDrive(12.5, 1.625, 1.625, &leftGroup, &rightGroup, &centerGroup, 1);
+    // chassis geometry, also checked against the compiled trajectory
+    const float track_width = 12.5;
+    const float wheel_radius = 1.625;
+    const float center_wheel_radius = 1.625;
+    const float drive_gear_ratio = 1;
+    chassis = new HDrive(track_width, wheel_radius, center_wheel_radius, &leftGroup, &rightGroup, &centerGroup, drive_gear_ratio);
     chassis->setOffset(0, 3, 0);
     chassis->setBrakeType(brakeType::brake);
     chassis->setMaxAcceleration(2, 2);
@@ -54,6 +60,11 @@ void init(void) {
 
     chassis->setStrafePID(strafe);
 
+    // Paths compiled by python_resources/compileTrajectory.py
+    if(routine.load("auton.traj")){
+        routine.checkChassis(track_width, wheel_radius, center_wheel_radius, drive_gear_ratio);
+    }
+
     // Fourbar setup
     // fourbar = new Mechanism(&mechGroup, 0.25);
     // fourbar->setBrakeType(brakeType::hold);